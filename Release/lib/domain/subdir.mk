@@ -5,19 +5,52 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
 ../lib/domain/Boundary.cpp \
+../lib/domain/ClearanceField.cpp \
+../lib/domain/CommandChannel.cpp \
+../lib/domain/CommandEncoder.cpp \
+../lib/domain/CommandSink.cpp \
+../lib/domain/DisplayServer.cpp \
+../lib/domain/PolygonArena.cpp \
+../lib/domain/PolygonUnion.cpp \
+../lib/domain/RayKernel.cpp \
 ../lib/domain/Room.cpp \
+../lib/domain/SegmentBVH.cpp \
+../lib/domain/SegmentGrid.cpp \
+../lib/domain/SegmentScene.cpp \
 ../lib/domain/Wall.cpp \
 ../lib/domain/World.cpp 
 
 OBJS += \
 ./lib/domain/Boundary.o \
+./lib/domain/ClearanceField.o \
+./lib/domain/CommandChannel.o \
+./lib/domain/CommandEncoder.o \
+./lib/domain/CommandSink.o \
+./lib/domain/DisplayServer.o \
+./lib/domain/PolygonArena.o \
+./lib/domain/PolygonUnion.o \
+./lib/domain/RayKernel.o \
 ./lib/domain/Room.o \
+./lib/domain/SegmentBVH.o \
+./lib/domain/SegmentGrid.o \
+./lib/domain/SegmentScene.o \
 ./lib/domain/Wall.o \
 ./lib/domain/World.o 
 
 CPP_DEPS += \
 ./lib/domain/Boundary.d \
+./lib/domain/ClearanceField.d \
+./lib/domain/CommandChannel.d \
+./lib/domain/CommandEncoder.d \
+./lib/domain/CommandSink.d \
+./lib/domain/DisplayServer.d \
+./lib/domain/PolygonArena.d \
+./lib/domain/PolygonUnion.d \
+./lib/domain/RayKernel.d \
 ./lib/domain/Room.d \
+./lib/domain/SegmentBVH.d \
+./lib/domain/SegmentGrid.d \
+./lib/domain/SegmentScene.d \
 ./lib/domain/Wall.d \
 ./lib/domain/World.d 
 
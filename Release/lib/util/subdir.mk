@@ -4,13 +4,16 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
-../lib/util/Socket.cpp 
+../lib/util/Socket.cpp \
+../lib/util/SocketReactor.cpp 
 
 OBJS += \
-./lib/util/Socket.o 
+./lib/util/Socket.o \
+./lib/util/SocketReactor.o 
 
 CPP_DEPS += \
-./lib/util/Socket.d 
+./lib/util/Socket.d \
+./lib/util/SocketReactor.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
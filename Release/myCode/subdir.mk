@@ -5,14 +5,20 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
 ../myCode/CSaugroboter.cpp \
+../myCode/CSimulation.cpp \
+../myCode/CThreadPool.cpp \
 ../myCode/main.cpp 
 
 OBJS += \
 ./myCode/CSaugroboter.o \
+./myCode/CSimulation.o \
+./myCode/CThreadPool.o \
 ./myCode/main.o 
 
 CPP_DEPS += \
 ./myCode/CSaugroboter.d \
+./myCode/CSimulation.d \
+./myCode/CThreadPool.d \
 ./myCode/main.d 
 
 
@@ -13,3 +13,11 @@ Boundary::Boundary() {
 
 Boundary::~Boundary() {
 }
+
+void Boundary::scan (const Point2D& origin, Scalar firstAngle,
+		             Scalar angleStep, size_t count,
+		             Scalar distances[]) const {
+	for (size_t i = 0; i < count; i++) {
+		distances[i] = distance(Ray2D(origin, firstAngle + i * angleStep));
+	}
+}
@@ -0,0 +1,395 @@
+/*
+ * @file ClearanceField.cpp
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <thread>
+#include "cleanerbot/ClearanceField.h"
+
+using namespace std;
+
+namespace {
+
+// Grid points around the walls' bounding box
+const int MARGIN = 2;
+const size_t MAX_SAMPLES = 4 * 1024 * 1024;
+// Rows or columns per thread, fewer are not worth starting a thread
+const int MIN_LINES_PER_THREAD = 64;
+
+/*
+ * Invoke body(begin, end) for consecutive ranges of [0, count),
+ * using several threads if there is enough work.
+ */
+template <class Body>
+void parallelFor (int count, const Body& body) {
+	int threads = min((int)max(1u, thread::hardware_concurrency()),
+					  max(1, count / MIN_LINES_PER_THREAD));
+	vector<thread> workers;
+	int chunk = (count + threads - 1) / threads;
+	for (int begin = chunk; begin < count; begin += chunk) {
+		workers.push_back(thread(body, begin, min(count, begin + chunk)));
+	}
+	body(0, min(count, chunk));
+	for (size_t i = 0; i < workers.size(); i++) {
+		workers[i].join();
+	}
+}
+
+}
+
+ClearanceField::ClearanceField()
+	: minX(0), minY(0), resolution(0), columns(0), rows(0) {
+}
+
+ClearanceField::~ClearanceField() {
+}
+
+bool ClearanceField::empty () const {
+	return columns == 0;
+}
+
+Scalar ClearanceField::getResolution () const {
+	return resolution;
+}
+
+Point2D ClearanceField::sample (int column, int row) const {
+	return Point2D(minX + column * resolution, minY + row * resolution);
+}
+
+void ClearanceField::build (const SegmentScene& edges,
+		const PolygonArena& shapes, Scalar resolution) {
+	this->resolution = resolution;
+	segments = edges;
+	values.clear();
+	features.clear();
+	inside.clear();
+	columns = rows = 0;
+	if (segments.size() == 0 || resolution <= 0) {
+		return;
+	}
+
+	Scalar maxX, maxY;
+	minX = minY = numeric_limits<Scalar>::max();
+	maxX = maxY = -numeric_limits<Scalar>::max();
+	for (size_t i = 0; i < segments.size(); i++) {
+		Scalar x0 = segments.x0s[i], y0 = segments.y0s[i];
+		Scalar x1 = x0 + segments.dxs[i], y1 = y0 + segments.dys[i];
+		minX = min(minX, min(x0, x1));
+		minY = min(minY, min(y0, y1));
+		maxX = max(maxX, max(x0, x1));
+		maxY = max(maxY, max(y0, y1));
+	}
+	while (true) {
+		columns = (int)ceil((maxX - minX) / this->resolution) + 2 * MARGIN + 1;
+		rows = (int)ceil((maxY - minY) / this->resolution) + 2 * MARGIN + 1;
+		if ((size_t)columns * rows <= MAX_SAMPLES) {
+			break;
+		}
+		this->resolution *= 2;
+	}
+	minX -= MARGIN * this->resolution;
+	minY -= MARGIN * this->resolution;
+
+	size_t n = (size_t)columns * rows;
+	values.assign(n, numeric_limits<Scalar>::max());
+	features.assign(n, -1);
+	inside.assign(n, 0);
+	vector<int> queue;
+	for (size_t i = 0; i < segments.size(); i++) {
+		seed(i, queue);
+	}
+	transform(queue);
+	// The transform finds the edge of the nearest seed, which is not
+	// always the nearest edge. Propagating the edges to the neighbours
+	// corrects this and yields the same result as incremental updates.
+	queue.resize(n);
+	for (size_t i = 0; i < n; i++) {
+		queue[i] = i;
+	}
+	propagate(queue);
+	vector<int> flipped;
+	markInside(shapes.range(), flipped);
+	for (size_t i = 0; i < flipped.size(); i++) {
+		values[flipped[i]] = -values[flipped[i]];
+	}
+}
+
+bool ClearanceField::add (const Wall& wall) {
+	if (empty()) {
+		return false;
+	}
+	const SegmentScene& added = wall.getSegments();
+	Scalar maxX = minX + (columns - 1) * resolution;
+	Scalar maxY = minY + (rows - 1) * resolution;
+	for (size_t i = 0; i < added.size(); i++) {
+		Scalar x0 = added.x0s[i], y0 = added.y0s[i];
+		Scalar x1 = x0 + added.dxs[i], y1 = y0 + added.dys[i];
+		if (min(x0, x1) < minX || max(x0, x1) > maxX
+			|| min(y0, y1) < minY || max(y0, y1) > maxY) {
+			return false;
+		}
+	}
+
+	size_t first = segments.size();
+	segments.add(added);
+	vector<int> flipped;
+	markInside(wall.shapeRange(), flipped);
+	for (size_t i = 0; i < flipped.size(); i++) {
+		values[flipped[i]] = -abs(values[flipped[i]]);
+	}
+	vector<int> queue;
+	for (size_t i = first; i < segments.size(); i++) {
+		seed(i, queue);
+	}
+	propagate(queue);
+	return true;
+}
+
+/*
+ * Assign the edge to the grid points close to it (if it is closer than
+ * their current edge) and append these points to the queue.
+ */
+void ClearanceField::seed (size_t edge, vector<int>& queue) {
+	Scalar x0 = segments.x0s[edge], y0 = segments.y0s[edge];
+	Scalar dx = segments.dxs[edge], dy = segments.dys[edge];
+	Scalar length = Vector2D(Point2D(0, 0), Point2D(dx, dy)).length();
+	int steps = max(1, (int)ceil(length / (resolution / 2)));
+	for (int k = 0; k <= steps; k++) {
+		Scalar u = Scalar(k) / steps;
+		int c = (int)floor((x0 + u * dx - minX) / resolution + Scalar(0.5));
+		int r = (int)floor((y0 + u * dy - minY) / resolution + Scalar(0.5));
+		for (int nr = max(0, r - 1); nr <= min(rows - 1, r + 1); nr++) {
+			for (int nc = max(0, c - 1); nc <= min(columns - 1, c + 1); nc++) {
+				int idx = nr * columns + nc;
+				if (features[idx] == (int)edge) {
+					continue;
+				}
+				Point2D p = sample(nc, nr);
+				Scalar d = segments.edgeDistance(edge, p.x(), p.y());
+				if (d < abs(values[idx])) {
+					values[idx] = inside[idx] ? -d : d;
+					features[idx] = edge;
+					queue.push_back(idx);
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Mark the grid points inside the polygons (even-odd rule per
+ * polygon, scanning the rows of grid points). Points that were not
+ * inside before are appended to flipped.
+ */
+void ClearanceField::markInside (const PolygonArena::Range& shapes,
+		                         vector<int>& flipped) {
+	vector<Scalar> crossings;
+	for (PolygonArena::Iterator poly = shapes.begin();
+		 poly != shapes.end(); poly++) {
+		Polygon2D::EdgeRange edges = poly->edgeRange();
+		if (edges.empty()) {
+			continue;
+		}
+		Scalar low = numeric_limits<Scalar>::max();
+		Scalar high = -numeric_limits<Scalar>::max();
+		for (Polygon2D::EdgeIterator edge = edges.begin();
+			 edge != edges.end(); ++edge) {
+			low = min(low, (*edge).start().y());
+			high = max(high, (*edge).start().y());
+		}
+		int r0 = max(0, (int)ceil((low - minY) / resolution));
+		int r1 = min(rows - 1, (int)floor((high - minY) / resolution));
+		for (int r = r0; r <= r1; r++) {
+			Scalar y = minY + r * resolution;
+			crossings.clear();
+			for (Polygon2D::EdgeIterator edge = edges.begin();
+				 edge != edges.end(); ++edge) {
+				Point2D s = (*edge).start();
+				Point2D e = (*edge).end();
+				if ((s.y() <= y) != (e.y() <= y)) {
+					crossings.push_back(s.x() + (y - s.y()) / (e.y() - s.y())
+										* (e.x() - s.x()));
+				}
+			}
+			sort(crossings.begin(), crossings.end());
+			for (size_t i = 0; i + 1 < crossings.size(); i += 2) {
+				int c0 = max(0,
+						(int)ceil((crossings[i] - minX) / resolution));
+				int c1 = min(columns - 1,
+						(int)floor((crossings[i + 1] - minX) / resolution));
+				for (int c = c0; c <= c1; c++) {
+					int idx = r * columns + c;
+					if (!inside[idx]) {
+						inside[idx] = 1;
+						flipped.push_back(idx);
+					}
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Assign the nearest seeded grid point's edge to all grid points. The
+ * first pass finds the nearest seed in the same column, the second
+ * pass computes the lower envelope of the parabolas
+ * (c - q)^2 + g(q) for each row. All computations are done on
+ * integers, the distances are then computed exactly for the
+ * edges found.
+ */
+void ClearanceField::transform (const vector<int>& seeds) {
+	if (seeds.empty()) {
+		return;
+	}
+	const vector<int> seedFeatures(features);
+	vector<int> nearestRow((size_t)columns * rows);
+
+	parallelFor(columns, [&](int begin, int end) {
+		for (int c = begin; c < end; c++) {
+			int last = -1;
+			for (int r = 0; r < rows; r++) {
+				if (seedFeatures[r * columns + c] >= 0) {
+					last = r;
+				}
+				nearestRow[r * columns + c] = last;
+			}
+			last = -1;
+			for (int r = rows - 1; r >= 0; r--) {
+				int idx = r * columns + c;
+				if (seedFeatures[idx] >= 0) {
+					last = r;
+				}
+				if (last >= 0 && (nearestRow[idx] < 0
+								  || last - r < r - nearestRow[idx])) {
+					nearestRow[idx] = last;
+				}
+			}
+		}
+	});
+
+	parallelFor(rows, [&](int begin, int end) {
+		// Envelope: parabola sites and the (rational) positions where
+		// they start to be the lowest.
+		vector<int> sites(columns);
+		vector<int64_t> startNum(columns);
+		vector<int64_t> startDen(columns);
+		for (int r = begin; r < end; r++) {
+			const int* nearest = &nearestRow[(size_t)r * columns];
+			int k = -1;
+			for (int q = 0; q < columns; q++) {
+				if (nearest[q] < 0) {
+					continue;
+				}
+				int64_t fq = int64_t(r - nearest[q]) * (r - nearest[q])
+					+ int64_t(q) * q;
+				int64_t num = 0, den = 1;
+				while (k >= 0) {
+					int v = sites[k];
+					int64_t fv = int64_t(r - nearest[v]) * (r - nearest[v])
+						+ int64_t(v) * v;
+					num = fq - fv;
+					den = 2 * int64_t(q - v);
+					// Drop the last site if q is lower where it starts
+					if (k > 0 && num * startDen[k] <= startNum[k] * den) {
+						k--;
+					} else {
+						break;
+					}
+				}
+				k++;
+				sites[k] = q;
+				startNum[k] = num;
+				startDen[k] = den;
+			}
+			int j = 0;
+			for (int c = 0; c < columns; c++) {
+				while (j < k && startNum[j + 1] < c * startDen[j + 1]) {
+					j++;
+				}
+				int q = sites[j];
+				int feature = seedFeatures[nearest[q] * columns + q];
+				int idx = r * columns + c;
+				Point2D p = sample(c, r);
+				features[idx] = feature;
+				values[idx] = segments.edgeDistance(feature, p.x(), p.y());
+			}
+		}
+	});
+}
+
+/*
+ * Propagate the edges of the queued grid points to their neighbours
+ * as long as this reduces the neighbours' distances.
+ */
+void ClearanceField::propagate (vector<int>& queue) {
+	for (size_t head = 0; head < queue.size(); head++) {
+		int idx = queue[head];
+		int feature = features[idx];
+		int c = idx % columns;
+		int r = idx / columns;
+		for (int nr = max(0, r - 1); nr <= min(rows - 1, r + 1); nr++) {
+			for (int nc = max(0, c - 1); nc <= min(columns - 1, c + 1); nc++) {
+				int nidx = nr * columns + nc;
+				if (features[nidx] == feature) {
+					continue;
+				}
+				Point2D p = sample(nc, nr);
+				Scalar d = segments.edgeDistance(feature, p.x(), p.y());
+				if (d < abs(values[nidx])) {
+					values[nidx] = inside[nidx] ? -d : d;
+					features[nidx] = feature;
+					queue.push_back(nidx);
+				}
+			}
+		}
+	}
+}
+
+Scalar ClearanceField::interpolate (const Point2D& position,
+		Scalar& gradX, Scalar& gradY) const {
+	Scalar px = (position.x() - minX) / resolution;
+	Scalar py = (position.y() - minY) / resolution;
+	Scalar gx = max(Scalar(0), min(Scalar(columns - 1), px));
+	Scalar gy = max(Scalar(0), min(Scalar(rows - 1), py));
+	int c = min(columns - 2, (int)floor(gx));
+	int r = min(rows - 2, (int)floor(gy));
+	Scalar fx = gx - c;
+	Scalar fy = gy - r;
+	const Scalar* row0 = &values[(size_t)r * columns + c];
+	const Scalar* row1 = row0 + columns;
+	Scalar bottom = row0[0] + (row0[1] - row0[0]) * fx;
+	Scalar top = row1[0] + (row1[1] - row1[0]) * fx;
+	gradX = ((row0[1] - row0[0]) * (1 - fy) + (row1[1] - row1[0]) * fy)
+		/ resolution;
+	gradY = (top - bottom) / resolution;
+	Scalar value = bottom + (top - bottom) * fy;
+	// Outside the grid, use the edge of the closest grid point
+	if (gx != px || gy != py) {
+		int closest = (int)floor(gy + Scalar(0.5)) * columns
+			+ (int)floor(gx + Scalar(0.5));
+		value = segments.edgeDistance(features[closest],
+									  position.x(), position.y());
+	}
+	return value;
+}
+
+Scalar ClearanceField::clearance (const Point2D& position) const {
+	if (empty()) {
+		return numeric_limits<Scalar>::max();
+	}
+	Scalar gradX, gradY;
+	return interpolate(position, gradX, gradY);
+}
+
+Vector2D ClearanceField::gradient (const Point2D& position) const {
+	if (empty()) {
+		return Vector2D(Point2D(0, 0), Point2D(0, 0));
+	}
+	Scalar gradX, gradY;
+	interpolate(position, gradX, gradY);
+	return Vector2D(Point2D(0, 0), Point2D(gradX, gradY));
+}
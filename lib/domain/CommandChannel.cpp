@@ -0,0 +1,344 @@
+/*
+ * @file CommandChannel.cpp
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#include <cstdlib>
+#include <ios>
+#include <iostream>
+#include <iterator>
+#include "cleanerbot/CommandChannel.h"
+
+using namespace std;
+
+const size_t CommandChannel::MAX_PENDING;
+
+CommandChannel::CommandChannel(const string& host, int port, bool tryBinary)
+	: socket(host, port) {
+	posted = 0;
+	taken = 0;
+	answered = 0;
+	stopping = false;
+	failed = false;
+	traceResponses = false;
+	showPending = false;
+	binary = false;
+	if (tryBinary) {
+		// Negotiate before the I/O thread starts, servers that do
+		// not know the command answer with an error code
+		CommandResponse response;
+		if (socket.SendBytes("PROTOCOL BINARY\r\n") < 0
+			|| !receive(response)) {
+			throw string("Verbindung zum Server verloren");
+		}
+		binary = response.code / 100 == 2;
+	}
+	ioThread = thread(&CommandChannel::run, this);
+}
+
+CommandChannel::~CommandChannel() {
+	{
+		unique_lock<std::mutex> lock(queueMutex);
+		stopping = true;
+	}
+	queued.notify_all();
+	ioThread.join();
+}
+
+void CommandChannel::setTraceResponses (bool trace) {
+	traceResponses = trace;
+}
+
+bool CommandChannel::isBinary () const {
+	return binary;
+}
+
+CommandEncoder::Format CommandChannel::format () const {
+	return binary ? CommandEncoder::FRAME : CommandEncoder::LINE;
+}
+
+/*
+ * Wait until another command may be posted and return the lock on
+ * the queue. The caller appends the command to outgoing and then
+ * calls endPost.
+ */
+unique_lock<std::mutex> CommandChannel::beginPost () {
+	unique_lock<std::mutex> lock(queueMutex);
+	progress.wait(lock, [this] {
+		return failed || posted - answered < MAX_PENDING;
+	});
+	if (failed) {
+		throw ios_base::failure("Verbindung zum Server verloren");
+	}
+	return lock;
+}
+
+void CommandChannel::endPost (unique_lock<std::mutex>& lock) {
+	posted += 1;
+	lock.unlock();
+	queued.notify_one();
+}
+
+void CommandChannel::post (const string& cmd) {
+	unique_lock<std::mutex> lock = beginPost();
+	CommandEncoder(outgoing, format()).text(cmd);
+	endPost(lock);
+}
+
+void CommandChannel::post (const char* cmd, const string& argument) {
+	unique_lock<std::mutex> lock = beginPost();
+	CommandEncoder(outgoing, format()).text(cmd, argument);
+	endPost(lock);
+}
+
+void CommandChannel::postShow (double positionX, double positionY,
+		double angle, double diameter) {
+	unique_lock<std::mutex> lock = beginPost();
+	CommandEncoder(outgoing, format())
+		.show(positionX, positionY, angle, diameter);
+	endPost(lock);
+}
+
+bool CommandChannel::postShow (double positionX, double positionY,
+		double angle, double diameter, Clock::duration interval) {
+	unique_lock<std::mutex> lock = beginPost();
+	bool replaced = showPending;
+	Clock::time_point now = Clock::now();
+	if (showPending || now - lastShow < interval) {
+		// Keep the position, the I/O thread sends it when it is due
+		if (!showPending) {
+			showPending = true;
+			showDue = lastShow + interval;
+		}
+		pendingX = positionX;
+		pendingY = positionY;
+		pendingAngle = angle;
+		pendingDiameter = diameter;
+		lock.unlock();
+		queued.notify_one();
+		return !replaced;
+	}
+	lastShow = now;
+	CommandEncoder(outgoing, format())
+		.show(positionX, positionY, angle, diameter);
+	endPost(lock);
+	return true;
+}
+
+/*
+ * Append the pending position to the outgoing commands. Must be
+ * called with the queue locked.
+ */
+void CommandChannel::postPendingShow () {
+	showPending = false;
+	lastShow = Clock::now();
+	CommandEncoder(outgoing, format())
+		.show(pendingX, pendingY, pendingAngle, pendingDiameter);
+	posted += 1;
+}
+
+void CommandChannel::flushShow () {
+	unique_lock<std::mutex> lock(queueMutex);
+	if (!showPending || failed) {
+		return;
+	}
+	postPendingShow();
+	lock.unlock();
+	queued.notify_one();
+}
+
+void CommandChannel::postWall (const PolygonRef& polygon) {
+	unique_lock<std::mutex> lock = beginPost();
+	CommandEncoder(outgoing, format()).wall(polygon);
+	endPost(lock);
+}
+
+future<CommandResponse> CommandChannel::request (const string& cmd) {
+	unique_lock<std::mutex> lock = beginPost();
+	Waiter waiter;
+	waiter.seq = posted;
+	waiter.result.reset(new promise<CommandResponse>());
+	future<CommandResponse> result = waiter.result->get_future();
+	waiters.push_back(std::move(waiter));
+	CommandEncoder(outgoing, format()).text(cmd);
+	endPost(lock);
+	return result;
+}
+
+void CommandChannel::flush () {
+	unique_lock<std::mutex> lock(queueMutex);
+	progress.wait(lock, [this] { return failed || answered == posted; });
+}
+
+/*
+ * Read response lines until a final (non-1xx) response arrives.
+ */
+bool CommandChannel::receive (CommandResponse& response) {
+	while (true) {
+		string line = socket.ReceiveLine();
+		if (line.size() == 0) {
+			return false;
+		}
+		size_t eol = line.find_first_of("\r\n");
+		if (eol != string::npos) {
+			line = line.substr(0, eol);
+		}
+		if (traceResponses) {
+			cerr << line << endl;
+		}
+		response.rest = line.size() > 4 ? line.substr(4) : "";
+		response.code = atoi(line.substr(0, 3).c_str());
+		if (response.code / 100 != 1) {
+			return true;
+		}
+	}
+}
+
+void CommandChannel::traceResponse (const CommandResponse& response) {
+	if (traceResponses) {
+		cerr << response.code << " " << response.rest << endl;
+	}
+}
+
+/*
+ * Pass the response to the caller waiting for the command with
+ * number seq, if any.
+ */
+void CommandChannel::complete (uint64_t seq, deque<Waiter>& batchWaiters,
+		const CommandResponse& response) {
+	if (!batchWaiters.empty() && batchWaiters.front().seq == seq) {
+		batchWaiters.front().result->set_value(response);
+		batchWaiters.pop_front();
+	}
+}
+
+/*
+ * Receive the next response(s) for the sent commands, starting with
+ * the command with number next, which is advanced accordingly.
+ * Returns false if the connection is lost or the server violates
+ * the protocol.
+ */
+bool CommandChannel::receive (uint64_t& next, deque<Waiter>& batchWaiters) {
+	CommandResponse response;
+	if (!binary) {
+		if (!receive(response)) {
+			return false;
+		}
+		complete(next++, batchWaiters, response);
+		return true;
+	}
+	unsigned char header[5];
+	if (!socket.ReceiveExactly(reinterpret_cast<char*>(header), 5)) {
+		return false;
+	}
+	uint32_t length = CommandEncoder::getUint(header, 4);
+	if (length < 1) {
+		return false;
+	}
+	string payload(length - 1, '\0');
+	if (!socket.ReceiveExactly(&payload[0], payload.size())) {
+		return false;
+	}
+	const unsigned char* data
+		= reinterpret_cast<const unsigned char*>(payload.data());
+	if (header[4] == CommandEncoder::FRAME_ACK && payload.size() == 4) {
+		uint32_t count = CommandEncoder::getUint(data, 4);
+		if (count > taken - next) {
+			return false;
+		}
+		response.code = 200;
+		for (uint32_t i = 0; i < count; i++) {
+			traceResponse(response);
+			complete(next++, batchWaiters, response);
+		}
+		return true;
+	}
+	if (header[4] == CommandEncoder::FRAME_RESPONSE && payload.size() >= 2) {
+		response.code = CommandEncoder::getUint(data, 2);
+		response.rest = payload.substr(2);
+		traceResponse(response);
+		complete(next++, batchWaiters, response);
+		return true;
+	}
+	return false;
+}
+
+/*
+ * The I/O thread. It takes all posted commands, sends them with a
+ * single call and then reads their responses in order. Commands
+ * posted in the meantime form the next batch.
+ */
+void CommandChannel::run () {
+	string sending;
+	deque<Waiter> batchWaiters;
+	while (true) {
+		uint64_t next;
+		uint64_t last;
+		{
+			unique_lock<std::mutex> lock(queueMutex);
+			while (true) {
+				// Send a pending position when its frame has ended
+				// (or before the channel is closed)
+				if (showPending && (stopping || Clock::now() >= showDue)) {
+					postPendingShow();
+				}
+				if (stopping || taken < posted) {
+					break;
+				}
+				if (showPending) {
+					queued.wait_until(lock, showDue);
+				} else {
+					queued.wait(lock);
+				}
+			}
+			if (taken == posted) {
+				return;
+			}
+			sending.clear();
+			sending.swap(outgoing);
+			next = taken;
+			last = taken = posted;
+			while (!waiters.empty() && waiters.front().seq < last) {
+				batchWaiters.push_back(std::move(waiters.front()));
+				waiters.pop_front();
+			}
+		}
+		bool ok = true;
+		size_t sent = 0;
+		while (ok && sent < sending.size()) {
+			int res = socket.SendBytes(sending.data() + sent,
+									   sending.size() - sent);
+			ok = res > 0;
+			sent += ok ? res : 0;
+		}
+		while (ok && next < last) {
+			ok = receive(next, batchWaiters);
+		}
+		unique_lock<std::mutex> lock(queueMutex);
+		if (!ok) {
+			// Fail all callers waiting for a response, including
+			// those of commands posted in the meantime
+			failed = true;
+			waiters.insert(waiters.begin(),
+				make_move_iterator(batchWaiters.begin()),
+				make_move_iterator(batchWaiters.end()));
+			for (deque<Waiter>::iterator waiter = waiters.begin();
+				 waiter != waiters.end(); waiter++) {
+				waiter->result->set_exception(make_exception_ptr
+					(ios_base::failure("Verbindung zum Server verloren")));
+			}
+			waiters.clear();
+			outgoing.clear();
+			taken = answered = posted;
+		} else {
+			answered = last;
+		}
+		batchWaiters.clear();
+		lock.unlock();
+		progress.notify_all();
+		if (!ok) {
+			return;
+		}
+	}
+}
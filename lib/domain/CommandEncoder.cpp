@@ -0,0 +1,183 @@
+/*
+ * @file CommandEncoder.cpp
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <cstring>
+#include <charconv>
+#include "cleanerbot/CommandEncoder.h"
+
+using namespace std;
+
+namespace {
+
+	// Coordinates are formatted with the precision of Scalar
+
+	inline double plain (double value) {
+		return value;
+	}
+
+	inline float plain (float value) {
+		return value;
+	}
+
+	inline double plain (GeometryLib::Fixed value) {
+		return static_cast<double>(value);
+	}
+
+}
+
+CommandEncoder::CommandEncoder(string& buffer, Format format)
+	: buffer(buffer), format(format), frameStart(0) {
+}
+
+CommandEncoder::~CommandEncoder() {
+}
+
+/*
+ * Start a command. For frames, the length is filled in by end.
+ */
+void CommandEncoder::begin (FrameType type) {
+	if (format != FRAME) {
+		return;
+	}
+	frameStart = buffer.size();
+	uint32(0);
+	buffer += static_cast<char>(type);
+}
+
+void CommandEncoder::end () {
+	if (format == LINE) {
+		buffer.append("\r\n", 2);
+	} else if (format == FRAME) {
+		uint32_t length = buffer.size() - frameStart - 4;
+		for (int i = 0; i < 4; i++) {
+			buffer[frameStart + i] = static_cast<char>((length >> (8 * i)) & 0xff);
+		}
+	}
+}
+
+void CommandEncoder::number (double value) {
+	char digits[32];
+	to_chars_result res = to_chars(digits, digits + sizeof(digits), value);
+	buffer.append(digits, res.ptr - digits);
+}
+
+void CommandEncoder::number (float value) {
+	char digits[32];
+	to_chars_result res = to_chars(digits, digits + sizeof(digits), value);
+	buffer.append(digits, res.ptr - digits);
+}
+
+// Little endian, independent of the host's byte order
+void CommandEncoder::uint32 (uint32_t value) {
+	char bytes[4];
+	for (int i = 0; i < 4; i++) {
+		bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+	}
+	buffer.append(bytes, 4);
+}
+
+void CommandEncoder::float32 (double value) {
+	float f = static_cast<float>(value);
+	uint32_t bits;
+	memcpy(&bits, &f, sizeof(bits));
+	uint32(bits);
+}
+
+uint32_t CommandEncoder::getUint (const unsigned char* data, int bytes) {
+	uint32_t value = 0;
+	for (int i = bytes - 1; i >= 0; i--) {
+		value = (value << 8) | data[i];
+	}
+	return value;
+}
+
+void CommandEncoder::text (const string& cmd) {
+	begin(FRAME_TEXT);
+	buffer += cmd;
+	end();
+}
+
+void CommandEncoder::text (const char* cmd, const string& argument) {
+	begin(FRAME_TEXT);
+	buffer += cmd;
+	buffer += argument;
+	end();
+}
+
+void CommandEncoder::show (double positionX, double positionY,
+		double angle, double diameter) {
+	begin(FRAME_SHOW);
+	if (format == FRAME) {
+		float32(positionX);
+		float32(positionY);
+		float32(cos(angle));
+		float32(sin(angle));
+		float32(diameter);
+	} else {
+		buffer += "VACUUM CLEANER ";
+		number(positionX);
+		buffer += ',';
+		number(positionY);
+		buffer += ';';
+		number(cos(angle));
+		buffer += ',';
+		number(sin(angle));
+		buffer += ';';
+		number(diameter);
+	}
+	end();
+}
+
+void CommandEncoder::wall (const PolygonRef& polygon) {
+	PolygonRef::VertexRange vertices = polygon.vertices();
+	begin(FRAME_WALL);
+	if (format == FRAME) {
+		uint32(vertices.size());
+		for (const Point2D* vi = vertices.begin();
+			 vi != vertices.end(); vi++) {
+			float32(plain(vi->x()));
+			float32(plain(vi->y()));
+		}
+	} else {
+		buffer += "WALL ";
+		for (const Point2D* vi = vertices.begin();
+			 vi != vertices.end(); vi++) {
+			if (vi != vertices.begin()) {
+				buffer += ';';
+			}
+			number(plain(vi->x()));
+			buffer += ',';
+			number(plain(vi->y()));
+		}
+	}
+	end();
+}
+
+void CommandEncoder::response (int code, const string& rest) {
+	begin(FRAME_RESPONSE);
+	if (format == FRAME) {
+		buffer += static_cast<char>(code & 0xff);
+		buffer += static_cast<char>((code >> 8) & 0xff);
+	} else {
+		char digits[16];
+		to_chars_result res = to_chars(digits, digits + sizeof(digits), code);
+		buffer.append(digits, res.ptr - digits);
+		buffer += ' ';
+	}
+	buffer += rest;
+	end();
+}
+
+void CommandEncoder::ack (uint32_t count) {
+	if (format != FRAME) {
+		return;
+	}
+	begin(FRAME_ACK);
+	uint32(count);
+	end();
+}
@@ -0,0 +1,13 @@
+/*
+ * @file CommandSink.cpp
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#include "cleanerbot/CommandSink.h"
+
+CommandSink::CommandSink() {
+}
+
+CommandSink::~CommandSink() {
+}
@@ -0,0 +1,420 @@
+/*
+ * @file DisplayServer.cpp
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#ifdef __linux__
+
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include "cleanerbot/DisplayServer.h"
+
+using namespace std;
+
+const int DisplayServer::HISTOGRAM_BUCKETS;
+
+namespace {
+
+	const char* const typeNames[] = {
+		"SET NAME", "START SCENE", "WALL", "END SCENE", "VACUUM CLEANER",
+		"STATUSLINE", "GET KEY", "CLOSE", "PROTOCOL", "(unbekannt)"
+	};
+
+	bool startsWith(const string& text, const char* prefix) {
+		return text.compare(0, strlen(prefix), prefix) == 0;
+	}
+
+	/*
+	 * Parse numbers separated by ',' or ';' (as in WALL and VACUUM
+	 * CLEANER). Returns the number of values or -1 if the text is
+	 * malformed.
+	 */
+	int countNumbers(const char* text) {
+		int count = 0;
+		while (true) {
+			char* end;
+			strtod(text, &end);
+			if (end == text) {
+				return -1;
+			}
+			count += 1;
+			if (*end == '\0') {
+				return count;
+			}
+			if (*end != ',' && *end != ';') {
+				return -1;
+			}
+			text = end + 1;
+		}
+	}
+
+}
+
+DisplayServer::DisplayServer(int port)
+	: server(port, 128), reactor(*this) {
+	latency = Clock::duration::zero();
+	binarySupported = true;
+	keys.push_back("q");
+	nextKey = 0;
+	wallVertices = 0;
+	bytesReceived = 0;
+	connections = 0;
+	stopped = false;
+	for (int i = 0; i < COMMAND_TYPES; i++) {
+		statistics[i].count = 0;
+		for (int b = 0; b < HISTOGRAM_BUCKETS; b++) {
+			statistics[i].histogram[b] = 0;
+		}
+	}
+	reactor.Listen(server);
+}
+
+DisplayServer::~DisplayServer() {
+}
+
+void DisplayServer::setLatency (double seconds) {
+	latency = chrono::duration_cast<Clock::duration>
+		(chrono::duration<double>(seconds));
+}
+
+void DisplayServer::setBinarySupported (bool supported) {
+	binarySupported = supported;
+}
+
+void DisplayServer::setKeys (const vector<string>& keys) {
+	if (!keys.empty()) {
+		this->keys = keys;
+		nextKey = 0;
+	}
+}
+
+void DisplayServer::OnConnect (ReactorConnection& con) {
+	Client& client = clients[con.Id()];
+	client.binary = false;
+	client.unacknowledged = 0;
+	client.delayed = 0;
+	client.ended = false;
+	connections += 1;
+}
+
+/*
+ * The client has finished sending (e.g. after CLOSE). Close the
+ * connection once the replies still waiting for the latency are sent.
+ */
+void DisplayServer::OnEnd (ReactorConnection& con) {
+	Client& client = clients[con.Id()];
+	client.ended = true;
+	if (client.delayed == 0) {
+		con.Close();
+	}
+}
+
+void DisplayServer::OnClose (ReactorConnection& con) {
+	clients.erase(con.Id());
+}
+
+/*
+ * Handle all complete commands received so far. The replies are
+ * collected and sent together, delayed by the configured latency.
+ */
+void DisplayServer::OnData (ReactorConnection& con) {
+	Client& client = clients[con.Id()];
+	Reply reply;
+	reply.received = Clock::now();
+	for (int i = 0; i < COMMAND_TYPES; i++) {
+		reply.counts[i] = 0;
+	}
+	reply.close = false;
+
+	string& input = con.Input();
+	size_t pos = 0;
+	bool ok = true;
+	while (ok && !reply.close) {
+		if (!client.binary) {
+			size_t eol = input.find('\n', pos);
+			if (eol == string::npos) {
+				break;
+			}
+			string line = input.substr(pos, eol - pos);
+			pos = eol + 1;
+			if (!line.empty() && line[line.size() - 1] == '\r') {
+				line.erase(line.size() - 1);
+			}
+			ok = handleLine(client, line, reply);
+		} else {
+			if (input.size() - pos < 5) {
+				break;
+			}
+			uint32_t length = CommandEncoder::getUint
+				(reinterpret_cast<const unsigned char*>(input.data() + pos), 4);
+			if (length < 1) {
+				ok = false;
+				break;
+			}
+			if (input.size() - pos < 4 + length) {
+				break;
+			}
+			uint8_t type = input[pos + 4];
+			string payload = input.substr(pos + 5, length - 1);
+			pos += 4 + length;
+			ok = handleFrame(client, type, payload, reply);
+		}
+	}
+	flushAcks(client, reply);
+	bytesReceived += pos;
+	input.erase(0, pos);
+	if (!ok) {
+		// Protocol violation, drop the connection
+		reply.close = true;
+	}
+
+	if (latency == Clock::duration::zero()) {
+		send(con.Id(), reply);
+	} else {
+		int id = con.Id();
+		client.delayed += 1;
+		reactor.AddTimer(chrono::duration<double>(latency).count(),
+			[this, id, reply] () mutable { sendDelayed(id, reply); });
+	}
+}
+
+/*
+ * Handle a command of the text protocol (also used for text frames).
+ * Returns false if the connection must be dropped.
+ */
+bool DisplayServer::handleLine
+	(Client& client, const string& line, Reply& reply) {
+	if (line == "PROTOCOL BINARY") {
+		if (!binarySupported) {
+			answer(client, reply, PROTOCOL, 500, "Unknown command");
+			return true;
+		}
+		// Confirm in the old protocol, then switch
+		answer(client, reply, PROTOCOL, 200, "");
+		client.binary = true;
+	} else if (startsWith(line, "SET NAME ")) {
+		client.name = line.substr(9);
+		answer(client, reply, SET_NAME, 200, "");
+	} else if (line == "START SCENE") {
+		answer(client, reply, START_SCENE, 200, "");
+	} else if (startsWith(line, "WALL ")) {
+		int count = countNumbers(line.c_str() + 5);
+		if (count < 2 || count % 2 != 0) {
+			answer(client, reply, WALL, 400, "Invalid arguments");
+		} else {
+			wallVertices += count / 2;
+			answer(client, reply, WALL, 200, "");
+		}
+	} else if (line == "END SCENE") {
+		answer(client, reply, END_SCENE, 200, "");
+	} else if (startsWith(line, "VACUUM CLEANER ")) {
+		if (countNumbers(line.c_str() + 15) != 5) {
+			answer(client, reply, VACUUM_CLEANER, 400, "Invalid arguments");
+		} else {
+			answer(client, reply, VACUUM_CLEANER, 200, "");
+		}
+	} else if (line == "STATUSLINE" || startsWith(line, "STATUSLINE ")) {
+		answer(client, reply, STATUSLINE, 200, "");
+	} else if (line == "GET KEY") {
+		if (!client.binary) {
+			// Like the console, which answers when a key is pressed
+			CommandEncoder(reply.data, CommandEncoder::LINE)
+				.response(100, "Waiting for key");
+		}
+		const string& key = keys[nextKey];
+		nextKey = (nextKey + 1) % keys.size();
+		answer(client, reply, GET_KEY, 200, "\"" + key + "\"");
+	} else if (line == "CLOSE") {
+		answer(client, reply, CLOSE, 200, "");
+		reply.close = true;
+	} else {
+		answer(client, reply, UNKNOWN, 500, "Unknown command");
+	}
+	return true;
+}
+
+/*
+ * Handle a frame of the binary protocol. Returns false if the
+ * connection must be dropped.
+ */
+bool DisplayServer::handleFrame (Client& client, uint8_t type,
+		const string& payload, Reply& reply) {
+	const unsigned char* data
+		= reinterpret_cast<const unsigned char*>(payload.data());
+	switch (type) {
+	case CommandEncoder::FRAME_TEXT:
+		return handleLine(client, payload, reply);
+	case CommandEncoder::FRAME_SHOW:
+		if (payload.size() != 5 * 4) {
+			return false;
+		}
+		answer(client, reply, VACUUM_CLEANER, 200, "");
+		return true;
+	case CommandEncoder::FRAME_WALL: {
+		if (payload.size() < 4) {
+			return false;
+		}
+		uint32_t count = CommandEncoder::getUint(data, 4);
+		if (payload.size() != 4 + 8 * size_t(count)) {
+			return false;
+		}
+		wallVertices += count;
+		answer(client, reply, WALL, 200, "");
+		return true;
+	}
+	default:
+		answer(client, reply, UNKNOWN, 500, "Unknown frame");
+		return true;
+	}
+}
+
+/*
+ * Answer a command. In the binary protocol, plain successes (code 200
+ * without text) are collected and acknowledged together.
+ */
+void DisplayServer::answer (Client& client, Reply& reply, CommandType type,
+		int code, const string& rest) {
+	reply.counts[type] += 1;
+	if (!client.binary) {
+		CommandEncoder(reply.data, CommandEncoder::LINE)
+			.response(code, rest.empty() ? "OK" : rest);
+		return;
+	}
+	if (code == 200 && rest.empty()) {
+		client.unacknowledged += 1;
+		return;
+	}
+	flushAcks(client, reply);
+	CommandEncoder(reply.data, CommandEncoder::FRAME).response(code, rest);
+}
+
+void DisplayServer::flushAcks (Client& client, Reply& reply) {
+	if (client.unacknowledged > 0) {
+		CommandEncoder(reply.data, CommandEncoder::FRAME)
+			.ack(client.unacknowledged);
+		client.unacknowledged = 0;
+	}
+}
+
+void DisplayServer::send (int id, Reply& reply) {
+	ReactorConnection* con = reactor.Find(id);
+	if (con != NULL) {
+		con->Send(reply.data);
+		if (reply.close) {
+			con->Close();
+		}
+	}
+	record(reply);
+}
+
+void DisplayServer::sendDelayed (int id, Reply& reply) {
+	send(id, reply);
+	map<int, Client>::iterator client = clients.find(id);
+	if (client == clients.end()) {
+		return;
+	}
+	client->second.delayed -= 1;
+	if (client->second.delayed == 0 && client->second.ended) {
+		ReactorConnection* con = reactor.Find(id);
+		if (con != NULL) {
+			con->Close();
+		}
+	}
+}
+
+/*
+ * Add the commands answered by the reply to the statistics.
+ */
+void DisplayServer::record (const Reply& reply) {
+	long us = chrono::duration_cast<chrono::microseconds>
+		(Clock::now() - reply.received).count();
+	int bucket = 0;
+	while (bucket < HISTOGRAM_BUCKETS - 1 && (1L << bucket) <= us) {
+		bucket += 1;
+	}
+	for (int i = 0; i < COMMAND_TYPES; i++) {
+		if (reply.counts[i] == 0) {
+			continue;
+		}
+		Statistics& stats = statistics[i];
+		if (stats.count == 0) {
+			stats.first = reply.received;
+		}
+		stats.last = reply.received;
+		stats.count += reply.counts[i];
+		stats.histogram[bucket] += reply.counts[i];
+	}
+}
+
+void DisplayServer::runOnce (int timeoutMs) {
+	reactor.RunOnce(timeoutMs);
+}
+
+void DisplayServer::run (double seconds) {
+	stopped = false;
+	Clock::time_point end = Clock::now()
+		+ chrono::duration_cast<Clock::duration>
+			(chrono::duration<double>(seconds));
+	while (!stopped && (seconds <= 0 || Clock::now() < end)) {
+		reactor.RunOnce(100);
+	}
+}
+
+void DisplayServer::stop () {
+	stopped = true;
+}
+
+unsigned long DisplayServer::getCount (CommandType type) const {
+	return statistics[type].count;
+}
+
+void DisplayServer::report (ostream& out) const {
+	out << "Verbindungen: " << connections << ", empfangen: "
+		<< bytesReceived << " Bytes, Ecken von Waenden: "
+		<< wallVertices << endl;
+	for (int i = 0; i < COMMAND_TYPES; i++) {
+		const Statistics& stats = statistics[i];
+		if (stats.count == 0) {
+			continue;
+		}
+		out << left << setw(16) << typeNames[i] << right
+			<< setw(10) << stats.count << " Kommandos";
+		double seconds = chrono::duration<double>
+			(stats.last - stats.first).count();
+		if (seconds > 0) {
+			out << ", " << stats.count / seconds << " /s";
+		}
+		out << endl;
+		// Upper bounds of the buckets containing the median and the
+		// 99th percentile, followed by all non-empty buckets
+		unsigned long sum = 0;
+		int median = -1;
+		int p99 = -1;
+		for (int b = 0; b < HISTOGRAM_BUCKETS; b++) {
+			sum += stats.histogram[b];
+			if (median < 0 && sum * 2 >= stats.count) {
+				median = b;
+			}
+			if (p99 < 0 && sum * 100 >= stats.count * 99) {
+				p99 = b;
+			}
+		}
+		out << "    Antwortzeit: Median < " << (1L << median)
+			<< " us, 99% < " << (1L << p99) << " us" << endl;
+		for (int b = 0; b < HISTOGRAM_BUCKETS; b++) {
+			if (stats.histogram[b] == 0) {
+				continue;
+			}
+			if (b < HISTOGRAM_BUCKETS - 1) {
+				out << "    < " << setw(8) << (1L << b) << " us: ";
+			} else {
+				out << "    >= " << setw(7) << (1L << (b - 1)) << " us: ";
+			}
+			out << stats.histogram[b] << endl;
+		}
+	}
+}
+
+#endif
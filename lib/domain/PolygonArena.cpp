@@ -0,0 +1,100 @@
+/*
+ * @file PolygonArena.cpp
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#include <functional>
+#include "cleanerbot/PolygonArena.h"
+
+using namespace std;
+
+PolygonRef::PolygonRef(const Point2D* points, size_t count)
+	: points(points), count(count) {
+}
+
+PolygonRef::PolygonRef(const Polygon2D& polygon)
+	: points(polygon.vertices().data()), count(polygon.vertices().size()) {
+}
+
+PolygonRef::VertexRange PolygonRef::vertices () const {
+	return VertexRange(points, points + count);
+}
+
+size_t PolygonRef::edgeCount () const {
+	return count < 2 ? 0 : count == 2 ? 1 : count;
+}
+
+Polygon2D::EdgeRange PolygonRef::edgeRange () const {
+	return Polygon2D::EdgeRange
+		(Polygon2D::EdgeIterator(points, count, 0),
+		 Polygon2D::EdgeIterator(points, count, edgeCount()));
+}
+
+Polygon2D PolygonRef::toPolygon () const {
+	Polygon2D polygon;
+	for (size_t i = 0; i < count; i++) {
+		polygon.add(points[i]);
+	}
+	return polygon;
+}
+
+PolygonArena::PolygonArena() {
+	starts.push_back(0);
+}
+
+PolygonArena::~PolygonArena() {
+}
+
+size_t PolygonArena::add (const PolygonRef& polygon) {
+	PolygonRef::VertexRange vertices = polygon.vertices();
+	const Point2D* first = vertices.begin();
+	size_t count = vertices.end() - vertices.begin();
+	less<const Point2D*> before;
+	if (count > 0 && !before(first, points.data())
+		&& before(first, points.data() + points.size())) {
+		// A polygon of this arena (e.g. add(arena[i])): the insert
+		// below would read from the vector while it grows, so copy
+		// by index after making room
+		size_t offset = first - points.data();
+		points.reserve(points.size() + count);
+		for (size_t i = 0; i < count; i++) {
+			points.push_back(points[offset + i]);
+		}
+	} else {
+		points.insert(points.end(), vertices.begin(), vertices.end());
+	}
+	starts.push_back(points.size());
+	return starts.size() - 2;
+}
+
+size_t PolygonArena::size () const {
+	return starts.size() - 1;
+}
+
+size_t PolygonArena::vertexCount () const {
+	return points.size();
+}
+
+PolygonRef PolygonArena::operator[] (size_t index) const {
+	return PolygonRef(points.data() + starts[index],
+					  starts[index + 1] - starts[index]);
+}
+
+PolygonArena::Range PolygonArena::range () const {
+	return range(0, size());
+}
+
+PolygonArena::Range PolygonArena::range (size_t first, size_t last) const {
+	return Range(Iterator(this, first), Iterator(this, last));
+}
+
+void PolygonArena::reserve (size_t polygons, size_t vertices) {
+	starts.reserve(polygons + 1);
+	points.reserve(vertices);
+}
+
+void PolygonArena::clear () {
+	points.clear();
+	starts.resize(1);
+}
@@ -0,0 +1,302 @@
+/*
+ * @file PolygonUnion.cpp
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include "cleanerbot/PolygonUnion.h"
+
+using namespace std;
+using GeometryLib::orientation;
+
+namespace {
+
+typedef pair<Scalar, Scalar> Key;
+
+Key key (const Point2D& point) {
+	return Key(point.x(), point.y());
+}
+
+bool same (const Point2D& a, const Point2D& b) {
+	return a.x() == b.x() && a.y() == b.y();
+}
+
+int sign (Scalar value) {
+	return (value > 0) - (value < 0);
+}
+
+// Whether the point, which must be collinear with a and b, lies
+// strictly between a and b.
+bool between (const Point2D& a, const Point2D& b, const Point2D& point) {
+	if (same(point, a) || same(point, b)) {
+		return false;
+	}
+	return min(a.x(), b.x()) <= point.x() && point.x() <= max(a.x(), b.x())
+		&& min(a.y(), b.y()) <= point.y() && point.y() <= max(a.y(), b.y());
+}
+
+// Orders points on a line from a to b by their distance from a, using
+// the coordinate that changes most along the line.
+class AlongLine {
+private:
+	bool useX;
+	bool ascending;
+
+public:
+	AlongLine (const Point2D& a, const Point2D& b) {
+		Scalar dx = b.x() - a.x();
+		Scalar dy = b.y() - a.y();
+		useX = max(dx, -dx) >= max(dy, -dy);
+		ascending = (useX ? dx : dy) > 0;
+	}
+
+	bool operator() (const Point2D& p, const Point2D& q) const {
+		Scalar pc = useX ? p.x() : p.y();
+		Scalar qc = useX ? q.x() : q.y();
+		return ascending ? pc < qc : qc < pc;
+	}
+};
+
+}
+
+PolygonUnion::PolygonUnion() {
+	polygonStart.push_back(0);
+}
+
+PolygonUnion::~PolygonUnion() {
+}
+
+void PolygonUnion::add (const PolygonRef& polygon) {
+	vector<Point2D> points;
+	PolygonRef::VertexRange vertices = polygon.vertices();
+	for (const Point2D* p = vertices.begin(); p != vertices.end(); ++p) {
+		if (points.empty() || !same(points.back(), *p)) {
+			points.push_back(*p);
+		}
+	}
+	while (points.size() > 1 && same(points.back(), points.front())) {
+		points.pop_back();
+	}
+	int index = closed.size();
+	bool area = false;
+	if (points.size() > 2) {
+		// The lowest (leftmost) vertex is convex, so its orientation
+		// is the orientation of the polygon. Make it counter-clockwise.
+		size_t low = 0;
+		for (size_t i = 1; i < points.size(); i++) {
+			if (points[i].y() < points[low].y()
+				|| (points[i].y() == points[low].y()
+					&& points[i].x() < points[low].x())) {
+				low = i;
+			}
+		}
+		const Point2D& prev = points[(low + points.size() - 1) % points.size()];
+		const Point2D& next = points[(low + 1) % points.size()];
+		int turn = orientation(prev, points[low], next);
+		if (turn < 0) {
+			reverse(points.begin(), points.end());
+		}
+		area = turn != 0;
+	}
+	for (size_t i = 0; i + 1 < points.size(); i++) {
+		Edge edge = { points[i], points[i + 1], index };
+		edges.push_back(edge);
+	}
+	if (points.size() > 2) {
+		Edge edge = { points.back(), points.front(), index };
+		edges.push_back(edge);
+	}
+	polygonStart.push_back(edges.size());
+	closed.push_back(area);
+}
+
+size_t PolygonUnion::size () const {
+	return edges.size();
+}
+
+void PolygonUnion::split (vector<Edge>& pieces) const {
+	vector<vector<Point2D> > cuts(edges.size());
+	for (size_t i = 0; i < edges.size(); i++) {
+		cuts[i].push_back(edges[i].start);
+		cuts[i].push_back(edges[i].end);
+	}
+	for (size_t i = 0; i < edges.size(); i++) {
+		const Edge& e = edges[i];
+		for (size_t j = polygonStart[e.polygon + 1]; j < edges.size(); j++) {
+			const Edge& f = edges[j];
+			if (max(e.start.x(), e.end.x()) < min(f.start.x(), f.end.x())
+				|| max(f.start.x(), f.end.x()) < min(e.start.x(), e.end.x())
+				|| max(e.start.y(), e.end.y()) < min(f.start.y(), f.end.y())
+				|| max(f.start.y(), f.end.y()) < min(e.start.y(), e.end.y())) {
+				continue;
+			}
+			int o1 = orientation(e.start, e.end, f.start);
+			int o2 = orientation(e.start, e.end, f.end);
+			int o3 = orientation(f.start, f.end, e.start);
+			int o4 = orientation(f.start, f.end, e.end);
+			if (o1 * o2 < 0 && o3 * o4 < 0) {
+				// Proper crossing, both edges are split at the same point
+				Point2D crossing;
+				Segment2D(e.start, e.end).findIntersection
+					(crossing, Segment2D(f.start, f.end));
+				cuts[i].push_back(crossing);
+				cuts[j].push_back(crossing);
+				continue;
+			}
+			// End points touching the other edge (this includes the
+			// end points of collinear overlapping edges)
+			if (o1 == 0 && between(e.start, e.end, f.start)) {
+				cuts[i].push_back(f.start);
+			}
+			if (o2 == 0 && between(e.start, e.end, f.end)) {
+				cuts[i].push_back(f.end);
+			}
+			if (o3 == 0 && between(f.start, f.end, e.start)) {
+				cuts[j].push_back(e.start);
+			}
+			if (o4 == 0 && between(f.start, f.end, e.end)) {
+				cuts[j].push_back(e.end);
+			}
+		}
+	}
+	for (size_t i = 0; i < edges.size(); i++) {
+		vector<Point2D>& points = cuts[i];
+		sort(points.begin(), points.end(),
+			 AlongLine(edges[i].start, edges[i].end));
+		for (size_t k = 0; k + 1 < points.size(); k++) {
+			if (!same(points[k], points[k + 1])) {
+				Edge piece = { points[k], points[k + 1], edges[i].polygon };
+				pieces.push_back(piece);
+			}
+		}
+	}
+}
+
+bool PolygonUnion::inside (const Point2D& point, int polygon) const {
+	if (!closed[polygon]) {
+		return false;
+	}
+	// Winding number, evaluated with exact orientation tests
+	int winding = 0;
+	for (size_t i = polygonStart[polygon]; i < polygonStart[polygon + 1]; i++) {
+		const Point2D& u = edges[i].start;
+		const Point2D& v = edges[i].end;
+		if (u.y() <= point.y()) {
+			if (v.y() > point.y() && orientation(u, v, point) > 0) {
+				winding += 1;
+			}
+		} else if (v.y() <= point.y() && orientation(u, v, point) < 0) {
+			winding -= 1;
+		}
+	}
+	return winding != 0;
+}
+
+void PolygonUnion::outline (SegmentScene& scene) const {
+	vector<Edge> pieces;
+	split(pieces);
+
+	// Sort the pieces so that coincident pieces are adjacent
+	vector<pair<pair<Key, Key>, size_t> > order;
+	order.reserve(pieces.size());
+	for (size_t i = 0; i < pieces.size(); i++) {
+		Key a = key(pieces[i].start);
+		Key b = key(pieces[i].end);
+		order.push_back(make_pair(a < b ? make_pair(a, b) : make_pair(b, a), i));
+	}
+	sort(order.begin(), order.end());
+
+	vector<Edge> kept;
+	vector<int> members;
+	for (size_t first = 0; first < order.size(); ) {
+		size_t last = first;
+		while (last < order.size() && order[last].first == order[first].first) {
+			last += 1;
+		}
+		// Closed polygons on both sides of the piece make it an interior
+		// edge. Otherwise, the piece is kept once unless it lies inside
+		// another polygon.
+		int forward = 0;
+		int backward = 0;
+		const Edge* candidate = NULL;
+		members.clear();
+		for (size_t k = first; k < last; k++) {
+			const Edge& piece = pieces[order[k].second];
+			members.push_back(piece.polygon);
+			if (closed[piece.polygon]) {
+				if (key(piece.start) < key(piece.end)) {
+					forward += 1;
+				} else {
+					backward += 1;
+				}
+				if (candidate == NULL || !closed[candidate->polygon]) {
+					candidate = &piece;
+				}
+			} else if (candidate == NULL) {
+				candidate = &piece;
+			}
+		}
+		first = last;
+		if (forward > 0 && backward > 0) {
+			continue;
+		}
+		Point2D middle((candidate->start.x() + candidate->end.x()) / Scalar(2),
+					   (candidate->start.y() + candidate->end.y()) / Scalar(2));
+		bool covered = false;
+		for (size_t polygon = 0; polygon < closed.size() && !covered; polygon++) {
+			covered = find(members.begin(), members.end(), int(polygon))
+				== members.end() && inside(middle, polygon);
+		}
+		if (!covered) {
+			kept.push_back(*candidate);
+		}
+	}
+
+	// Merge runs of collinear pieces that meet at vertices without
+	// other edges
+	map<Key, vector<size_t> > outgoing;
+	map<Key, vector<size_t> > incoming;
+	for (size_t i = 0; i < kept.size(); i++) {
+		outgoing[key(kept[i].start)].push_back(i);
+		incoming[key(kept[i].end)].push_back(i);
+	}
+	vector<long> next(kept.size(), -1);
+	vector<bool> continued(kept.size(), false);
+	for (size_t i = 0; i < kept.size(); i++) {
+		const Edge& e = kept[i];
+		map<Key, vector<size_t> >::const_iterator out
+			= outgoing.find(key(e.end));
+		if (out == outgoing.end() || out->second.size() != 1
+			|| incoming[key(e.end)].size() != 1) {
+			continue;
+		}
+		const Edge& f = kept[out->second.front()];
+		if (out->second.front() != i && orientation(e.start, e.end, f.end) == 0
+			&& sign(e.end.x() - e.start.x()) == sign(f.end.x() - f.start.x())
+			&& sign(e.end.y() - e.start.y()) == sign(f.end.y() - f.start.y())) {
+			next[i] = out->second.front();
+			continued[out->second.front()] = true;
+		}
+	}
+	vector<bool> done(kept.size(), false);
+	for (size_t i = 0; i < kept.size(); i++) {
+		if (continued[i]) {
+			continue;
+		}
+		size_t last = i;
+		done[i] = true;
+		while (next[last] >= 0) {
+			last = next[last];
+			done[last] = true;
+		}
+		scene.add(Segment2D(kept[i].start, kept[last].end));
+	}
+	for (size_t i = 0; i < kept.size(); i++) {
+		if (!done[i]) {
+			scene.add(Segment2D(kept[i].start, kept[i].end));
+		}
+	}
+}
@@ -0,0 +1,595 @@
+/*
+ * @file RayKernel.cpp
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "cleanerbot/RayKernel.h"
+#include "geometrylib/Predicates.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RAYKERNEL_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+typedef double (*KernelFunc) (double, double, double, double,
+		const double*, const double*, const double*, const double*,
+		size_t, double);
+typedef float (*FloatKernelFunc) (float, float, float, float,
+		const float*, const float*, const float*, const float*,
+		size_t, float);
+
+/*
+ * All decisions depend on the signs of four cross products: the
+ * denominator r x e and the numerators w x e (t >= 0), w x r (u >= 0)
+ * and (q - o) x r (u <= 1, q = p + e). Each is evaluated as a * b - c * d
+ * from exact inputs or rounded differences, so its absolute error is
+ * at most ERROR_BOUND * (|a * b| + |c * d|), the bound for the
+ * orientation predicate (3 + 16 eps) * eps (Shewchuk) rounded up, with
+ * eps being half the machine epsilon (assuming no underflow). Values
+ * within that bound of zero are decided exactly.
+ */
+template <class T> struct Precision;
+
+template <> struct Precision<double> {
+	static constexpr double ERROR_BOUND = 1e-15; // as CROSS_ERROR_BOUND
+};
+
+template <> struct Precision<float> {
+	static constexpr float ERROR_BOUND = 2e-7f;
+};
+
+/*
+ * Ray: o + t*r with |r| = 1, edge: p + u*e with 0 <= u <= 1.
+ * Solving o + t*r = p + u*e with w = p - o gives
+ * t = (w x e) / (r x e) and u = (w x r) / (r x e).
+ *
+ * This function decides if there is a hit using the exact signs of
+ * the cross products. The end point q is passed as computed by the
+ * caller (p + e, rounded to the caller's precision), so that edges
+ * sharing a vertex remain connected. Returns infinity if there is no
+ * hit. Single precision arguments are represented exactly as double.
+ */
+double exactDistance (double ox, double oy, double rx, double ry,
+		double px, double py, double ex, double ey, double qx, double qy) {
+	using GeometryLib::Expansion;
+	const double none = std::numeric_limits<double>::infinity();
+	Expansion denom = Expansion(rx) * ey;
+	denom += -(Expansion(ry) * ex);
+	int sd = denom.sign();
+	if (sd == 0) {
+		return none; // parallel
+	}
+	Expansion wx = Expansion::difference(px, ox);
+	Expansion wy = Expansion::difference(py, oy);
+	// u >= 0
+	Expansion nu = wx * ry;
+	nu += -(wy * rx);
+	if (nu.sign() * sd < 0) {
+		return none;
+	}
+	// u <= 1, i.e. ((q - o) x r) / (r x e) <= 0
+	Expansion end = Expansion::difference(qx, ox) * ry;
+	end += -(Expansion::difference(qy, oy) * rx);
+	if (end.sign() * sd > 0) {
+		return none;
+	}
+	// t >= 0
+	Expansion nt = wx * ey;
+	nt += -(wy * ex);
+	int st = nt.sign() * sd;
+	if (st < 0) {
+		return none;
+	}
+	if (st == 0) {
+		return 0;
+	}
+	return std::max(0.0, nt.estimate() / denom.estimate());
+}
+
+/*
+ * The vector versions below evaluate exactly the same expressions
+ * (no contraction into fused multiply-add) and fall back to this
+ * function for groups of edges with uncertain signs, so all versions
+ * return identical results.
+ */
+template <class T>
+T scalarKernel (T ox, T oy, T rx, T ry, const T* x0, const T* y0,
+		const T* dx, const T* dy, size_t n, T maxDist) {
+	using std::abs;
+	const T bound = Precision<T>::ERROR_BOUND;
+	T dist = maxDist;
+	for (size_t i = 0; i < n; i++) {
+		T d1 = rx * dy[i];
+		T d2 = ry * dx[i];
+		T scale = abs(d1) + abs(d2);
+		if (scale == 0) {
+			continue; // parallel
+		}
+		T qx = x0[i] + dx[i];
+		T qy = y0[i] + dy[i];
+		T wx = x0[i] - ox;
+		T wy = y0[i] - oy;
+		T vx = qx - ox;
+		T vy = qy - oy;
+		T t1 = wx * dy[i], t2 = wy * dx[i];
+		T u1 = wx * ry, u2 = wy * rx;
+		T v1 = vx * ry, v2 = vy * rx;
+		T denom = d1 - d2;
+		T nt = t1 - t2;
+		T nu = u1 - u2;
+		T nv = v1 - v2;
+		if (abs(denom) <= bound * scale
+			|| abs(nt) <= bound * (abs(t1) + abs(t2))
+			|| abs(nu) <= bound * (abs(u1) + abs(u2))
+			|| abs(nv) <= bound * (abs(v1) + abs(v2))) {
+			double exact = exactDistance(ox, oy, rx, ry, x0[i], y0[i],
+				dx[i], dy[i], qx, qy);
+			if (exact < dist) {
+				dist = T(exact);
+			}
+			continue;
+		}
+		T t = nt / denom;
+		if (nt * denom > 0 && nu * denom > 0 && nv * denom < 0 && t < dist) {
+			dist = t;
+		}
+	}
+	return dist;
+}
+
+#ifdef RAYKERNEL_X86
+
+/*
+ * Lanes with a zero denominator fail the sign checks, so no explicit
+ * test for parallel edges is needed (unless the denominator is only
+ * zero due to rounding, which is handled as an uncertain result).
+ */
+__attribute__((target("sse2")))
+double sse2Kernel (double ox, double oy, double rx, double ry,
+		const double* x0, const double* y0, const double* dx,
+		const double* dy, size_t n, double maxDist) {
+	const __m128d vox = _mm_set1_pd(ox);
+	const __m128d voy = _mm_set1_pd(oy);
+	const __m128d vrx = _mm_set1_pd(rx);
+	const __m128d vry = _mm_set1_pd(ry);
+	const __m128d zero = _mm_setzero_pd();
+	const __m128d sign = _mm_set1_pd(-0.0);
+	const __m128d bound = _mm_set1_pd(Precision<double>::ERROR_BOUND);
+	__m128d best = _mm_set1_pd(maxDist);
+	size_t i = 0;
+	for (; i + 2 <= n; i += 2) {
+		__m128d px = _mm_loadu_pd(x0 + i);
+		__m128d py = _mm_loadu_pd(y0 + i);
+		__m128d ex = _mm_loadu_pd(dx + i);
+		__m128d ey = _mm_loadu_pd(dy + i);
+		__m128d wx = _mm_sub_pd(px, vox);
+		__m128d wy = _mm_sub_pd(py, voy);
+		__m128d vx = _mm_sub_pd(_mm_add_pd(px, ex), vox);
+		__m128d vy = _mm_sub_pd(_mm_add_pd(py, ey), voy);
+		__m128d d1 = _mm_mul_pd(vrx, ey);
+		__m128d d2 = _mm_mul_pd(vry, ex);
+		__m128d t1 = _mm_mul_pd(wx, ey);
+		__m128d t2 = _mm_mul_pd(wy, ex);
+		__m128d u1 = _mm_mul_pd(wx, vry);
+		__m128d u2 = _mm_mul_pd(wy, vrx);
+		__m128d v1 = _mm_mul_pd(vx, vry);
+		__m128d v2 = _mm_mul_pd(vy, vrx);
+		__m128d scale = _mm_add_pd
+			(_mm_andnot_pd(sign, d1), _mm_andnot_pd(sign, d2));
+		__m128d denom = _mm_sub_pd(d1, d2);
+		__m128d nt = _mm_sub_pd(t1, t2);
+		__m128d nu = _mm_sub_pd(u1, u2);
+		__m128d nv = _mm_sub_pd(v1, v2);
+		__m128d unsure = _mm_or_pd(
+			_mm_or_pd(
+				_mm_cmple_pd(_mm_andnot_pd(sign, denom),
+					_mm_mul_pd(bound, scale)),
+				_mm_cmple_pd(_mm_andnot_pd(sign, nt),
+					_mm_mul_pd(bound, _mm_add_pd(_mm_andnot_pd(sign, t1),
+						_mm_andnot_pd(sign, t2))))),
+			_mm_or_pd(
+				_mm_cmple_pd(_mm_andnot_pd(sign, nu),
+					_mm_mul_pd(bound, _mm_add_pd(_mm_andnot_pd(sign, u1),
+						_mm_andnot_pd(sign, u2)))),
+				_mm_cmple_pd(_mm_andnot_pd(sign, nv),
+					_mm_mul_pd(bound, _mm_add_pd(_mm_andnot_pd(sign, v1),
+						_mm_andnot_pd(sign, v2))))));
+		// Exactly parallel edges are skipped by the scalar version, too
+		unsure = _mm_and_pd(_mm_cmpgt_pd(scale, zero), unsure);
+		if (_mm_movemask_pd(unsure) != 0) {
+			best = _mm_min_pd(best, _mm_set1_pd(scalarKernel(ox, oy,
+				rx, ry, x0 + i, y0 + i, dx + i, dy + i, 2, maxDist)));
+			continue;
+		}
+		__m128d t = _mm_div_pd(nt, denom);
+		__m128d hit = _mm_and_pd
+			(_mm_and_pd(_mm_cmpgt_pd(_mm_mul_pd(nt, denom), zero),
+				_mm_cmplt_pd(t, best)),
+			 _mm_and_pd(_mm_cmpgt_pd(_mm_mul_pd(nu, denom), zero),
+				_mm_cmplt_pd(_mm_mul_pd(nv, denom), zero)));
+		best = _mm_or_pd(_mm_and_pd(hit, t), _mm_andnot_pd(hit, best));
+	}
+	double lanes[2];
+	_mm_storeu_pd(lanes, best);
+	double dist = lanes[0];
+	for (int l = 1; l < 2; l++) {
+		if (lanes[l] < dist) {
+			dist = lanes[l];
+		}
+	}
+	return scalarKernel(ox, oy, rx, ry, x0 + i, y0 + i, dx + i, dy + i,
+						n - i, dist);
+}
+
+/*
+ * Ordered comparisons for AVX, which only has a generic compare
+ * taking the predicate as an argument.
+ */
+__attribute__((target("avx2")))
+inline __m256d lessEqual (__m256d a, __m256d b) {
+	return _mm256_cmp_pd(a, b, _CMP_LE_OQ);
+}
+
+__attribute__((target("avx2")))
+inline __m256d greater (__m256d a, __m256d b) {
+	return _mm256_cmp_pd(a, b, _CMP_GT_OQ);
+}
+
+__attribute__((target("avx2")))
+inline __m256d less (__m256d a, __m256d b) {
+	return _mm256_cmp_pd(a, b, _CMP_LT_OQ);
+}
+
+__attribute__((target("avx2")))
+inline __m256 lessEqual (__m256 a, __m256 b) {
+	return _mm256_cmp_ps(a, b, _CMP_LE_OQ);
+}
+
+__attribute__((target("avx2")))
+inline __m256 greater (__m256 a, __m256 b) {
+	return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+}
+
+__attribute__((target("avx2")))
+inline __m256 less (__m256 a, __m256 b) {
+	return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+}
+
+__attribute__((target("avx2")))
+double avx2Kernel (double ox, double oy, double rx, double ry,
+		const double* x0, const double* y0, const double* dx,
+		const double* dy, size_t n, double maxDist) {
+	const __m256d vox = _mm256_set1_pd(ox);
+	const __m256d voy = _mm256_set1_pd(oy);
+	const __m256d vrx = _mm256_set1_pd(rx);
+	const __m256d vry = _mm256_set1_pd(ry);
+	const __m256d zero = _mm256_setzero_pd();
+	const __m256d sign = _mm256_set1_pd(-0.0);
+	const __m256d bound = _mm256_set1_pd(Precision<double>::ERROR_BOUND);
+	__m256d best = _mm256_set1_pd(maxDist);
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m256d px = _mm256_loadu_pd(x0 + i);
+		__m256d py = _mm256_loadu_pd(y0 + i);
+		__m256d ex = _mm256_loadu_pd(dx + i);
+		__m256d ey = _mm256_loadu_pd(dy + i);
+		__m256d wx = _mm256_sub_pd(px, vox);
+		__m256d wy = _mm256_sub_pd(py, voy);
+		__m256d vx = _mm256_sub_pd(_mm256_add_pd(px, ex), vox);
+		__m256d vy = _mm256_sub_pd(_mm256_add_pd(py, ey), voy);
+		__m256d d1 = _mm256_mul_pd(vrx, ey);
+		__m256d d2 = _mm256_mul_pd(vry, ex);
+		__m256d t1 = _mm256_mul_pd(wx, ey);
+		__m256d t2 = _mm256_mul_pd(wy, ex);
+		__m256d u1 = _mm256_mul_pd(wx, vry);
+		__m256d u2 = _mm256_mul_pd(wy, vrx);
+		__m256d v1 = _mm256_mul_pd(vx, vry);
+		__m256d v2 = _mm256_mul_pd(vy, vrx);
+		__m256d scale = _mm256_add_pd
+			(_mm256_andnot_pd(sign, d1), _mm256_andnot_pd(sign, d2));
+		__m256d denom = _mm256_sub_pd(d1, d2);
+		__m256d nt = _mm256_sub_pd(t1, t2);
+		__m256d nu = _mm256_sub_pd(u1, u2);
+		__m256d nv = _mm256_sub_pd(v1, v2);
+		__m256d unsure = _mm256_or_pd(
+			_mm256_or_pd(
+				lessEqual(_mm256_andnot_pd(sign, denom),
+					_mm256_mul_pd(bound, scale)),
+				lessEqual(_mm256_andnot_pd(sign, nt),
+					_mm256_mul_pd(bound, _mm256_add_pd(_mm256_andnot_pd(sign, t1),
+						_mm256_andnot_pd(sign, t2))))),
+			_mm256_or_pd(
+				lessEqual(_mm256_andnot_pd(sign, nu),
+					_mm256_mul_pd(bound, _mm256_add_pd(_mm256_andnot_pd(sign, u1),
+						_mm256_andnot_pd(sign, u2)))),
+				lessEqual(_mm256_andnot_pd(sign, nv),
+					_mm256_mul_pd(bound, _mm256_add_pd(_mm256_andnot_pd(sign, v1),
+						_mm256_andnot_pd(sign, v2))))));
+		// Exactly parallel edges are skipped by the scalar version, too
+		unsure = _mm256_and_pd(greater(scale, zero), unsure);
+		if (_mm256_movemask_pd(unsure) != 0) {
+			best = _mm256_min_pd(best, _mm256_set1_pd(scalarKernel(ox, oy,
+				rx, ry, x0 + i, y0 + i, dx + i, dy + i, 4, maxDist)));
+			continue;
+		}
+		__m256d t = _mm256_div_pd(nt, denom);
+		__m256d hit = _mm256_and_pd
+			(_mm256_and_pd(greater(_mm256_mul_pd(nt, denom), zero),
+				less(t, best)),
+			 _mm256_and_pd(greater(_mm256_mul_pd(nu, denom), zero),
+				less(_mm256_mul_pd(nv, denom), zero)));
+		best = _mm256_blendv_pd(best, t, hit);
+	}
+	double lanes[4];
+	_mm256_storeu_pd(lanes, best);
+	double dist = lanes[0];
+	for (int l = 1; l < 4; l++) {
+		if (lanes[l] < dist) {
+			dist = lanes[l];
+		}
+	}
+	return scalarKernel(ox, oy, rx, ry, x0 + i, y0 + i, dx + i, dy + i,
+						n - i, dist);
+}
+
+__attribute__((target("sse2")))
+float sse2FloatKernel (float ox, float oy, float rx, float ry,
+		const float* x0, const float* y0, const float* dx,
+		const float* dy, size_t n, float maxDist) {
+	const __m128 vox = _mm_set1_ps(ox);
+	const __m128 voy = _mm_set1_ps(oy);
+	const __m128 vrx = _mm_set1_ps(rx);
+	const __m128 vry = _mm_set1_ps(ry);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 sign = _mm_set1_ps(-0.0f);
+	const __m128 bound = _mm_set1_ps(Precision<float>::ERROR_BOUND);
+	__m128 best = _mm_set1_ps(maxDist);
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m128 px = _mm_loadu_ps(x0 + i);
+		__m128 py = _mm_loadu_ps(y0 + i);
+		__m128 ex = _mm_loadu_ps(dx + i);
+		__m128 ey = _mm_loadu_ps(dy + i);
+		__m128 wx = _mm_sub_ps(px, vox);
+		__m128 wy = _mm_sub_ps(py, voy);
+		__m128 vx = _mm_sub_ps(_mm_add_ps(px, ex), vox);
+		__m128 vy = _mm_sub_ps(_mm_add_ps(py, ey), voy);
+		__m128 d1 = _mm_mul_ps(vrx, ey);
+		__m128 d2 = _mm_mul_ps(vry, ex);
+		__m128 t1 = _mm_mul_ps(wx, ey);
+		__m128 t2 = _mm_mul_ps(wy, ex);
+		__m128 u1 = _mm_mul_ps(wx, vry);
+		__m128 u2 = _mm_mul_ps(wy, vrx);
+		__m128 v1 = _mm_mul_ps(vx, vry);
+		__m128 v2 = _mm_mul_ps(vy, vrx);
+		__m128 scale = _mm_add_ps
+			(_mm_andnot_ps(sign, d1), _mm_andnot_ps(sign, d2));
+		__m128 denom = _mm_sub_ps(d1, d2);
+		__m128 nt = _mm_sub_ps(t1, t2);
+		__m128 nu = _mm_sub_ps(u1, u2);
+		__m128 nv = _mm_sub_ps(v1, v2);
+		__m128 unsure = _mm_or_ps(
+			_mm_or_ps(
+				_mm_cmple_ps(_mm_andnot_ps(sign, denom),
+					_mm_mul_ps(bound, scale)),
+				_mm_cmple_ps(_mm_andnot_ps(sign, nt),
+					_mm_mul_ps(bound, _mm_add_ps(_mm_andnot_ps(sign, t1),
+						_mm_andnot_ps(sign, t2))))),
+			_mm_or_ps(
+				_mm_cmple_ps(_mm_andnot_ps(sign, nu),
+					_mm_mul_ps(bound, _mm_add_ps(_mm_andnot_ps(sign, u1),
+						_mm_andnot_ps(sign, u2)))),
+				_mm_cmple_ps(_mm_andnot_ps(sign, nv),
+					_mm_mul_ps(bound, _mm_add_ps(_mm_andnot_ps(sign, v1),
+						_mm_andnot_ps(sign, v2))))));
+		// Exactly parallel edges are skipped by the scalar version, too
+		unsure = _mm_and_ps(_mm_cmpgt_ps(scale, zero), unsure);
+		if (_mm_movemask_ps(unsure) != 0) {
+			best = _mm_min_ps(best, _mm_set1_ps(scalarKernel(ox, oy,
+				rx, ry, x0 + i, y0 + i, dx + i, dy + i, 4, maxDist)));
+			continue;
+		}
+		__m128 t = _mm_div_ps(nt, denom);
+		__m128 hit = _mm_and_ps
+			(_mm_and_ps(_mm_cmpgt_ps(_mm_mul_ps(nt, denom), zero),
+				_mm_cmplt_ps(t, best)),
+			 _mm_and_ps(_mm_cmpgt_ps(_mm_mul_ps(nu, denom), zero),
+				_mm_cmplt_ps(_mm_mul_ps(nv, denom), zero)));
+		best = _mm_or_ps(_mm_and_ps(hit, t), _mm_andnot_ps(hit, best));
+	}
+	float lanes[4];
+	_mm_storeu_ps(lanes, best);
+	float dist = lanes[0];
+	for (int l = 1; l < 4; l++) {
+		if (lanes[l] < dist) {
+			dist = lanes[l];
+		}
+	}
+	return scalarKernel(ox, oy, rx, ry, x0 + i, y0 + i, dx + i, dy + i,
+						n - i, dist);
+}
+
+__attribute__((target("avx2")))
+float avx2FloatKernel (float ox, float oy, float rx, float ry,
+		const float* x0, const float* y0, const float* dx,
+		const float* dy, size_t n, float maxDist) {
+	const __m256 vox = _mm256_set1_ps(ox);
+	const __m256 voy = _mm256_set1_ps(oy);
+	const __m256 vrx = _mm256_set1_ps(rx);
+	const __m256 vry = _mm256_set1_ps(ry);
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 sign = _mm256_set1_ps(-0.0f);
+	const __m256 bound = _mm256_set1_ps(Precision<float>::ERROR_BOUND);
+	__m256 best = _mm256_set1_ps(maxDist);
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256 px = _mm256_loadu_ps(x0 + i);
+		__m256 py = _mm256_loadu_ps(y0 + i);
+		__m256 ex = _mm256_loadu_ps(dx + i);
+		__m256 ey = _mm256_loadu_ps(dy + i);
+		__m256 wx = _mm256_sub_ps(px, vox);
+		__m256 wy = _mm256_sub_ps(py, voy);
+		__m256 vx = _mm256_sub_ps(_mm256_add_ps(px, ex), vox);
+		__m256 vy = _mm256_sub_ps(_mm256_add_ps(py, ey), voy);
+		__m256 d1 = _mm256_mul_ps(vrx, ey);
+		__m256 d2 = _mm256_mul_ps(vry, ex);
+		__m256 t1 = _mm256_mul_ps(wx, ey);
+		__m256 t2 = _mm256_mul_ps(wy, ex);
+		__m256 u1 = _mm256_mul_ps(wx, vry);
+		__m256 u2 = _mm256_mul_ps(wy, vrx);
+		__m256 v1 = _mm256_mul_ps(vx, vry);
+		__m256 v2 = _mm256_mul_ps(vy, vrx);
+		__m256 scale = _mm256_add_ps
+			(_mm256_andnot_ps(sign, d1), _mm256_andnot_ps(sign, d2));
+		__m256 denom = _mm256_sub_ps(d1, d2);
+		__m256 nt = _mm256_sub_ps(t1, t2);
+		__m256 nu = _mm256_sub_ps(u1, u2);
+		__m256 nv = _mm256_sub_ps(v1, v2);
+		__m256 unsure = _mm256_or_ps(
+			_mm256_or_ps(
+				lessEqual(_mm256_andnot_ps(sign, denom),
+					_mm256_mul_ps(bound, scale)),
+				lessEqual(_mm256_andnot_ps(sign, nt),
+					_mm256_mul_ps(bound, _mm256_add_ps(_mm256_andnot_ps(sign, t1),
+						_mm256_andnot_ps(sign, t2))))),
+			_mm256_or_ps(
+				lessEqual(_mm256_andnot_ps(sign, nu),
+					_mm256_mul_ps(bound, _mm256_add_ps(_mm256_andnot_ps(sign, u1),
+						_mm256_andnot_ps(sign, u2)))),
+				lessEqual(_mm256_andnot_ps(sign, nv),
+					_mm256_mul_ps(bound, _mm256_add_ps(_mm256_andnot_ps(sign, v1),
+						_mm256_andnot_ps(sign, v2))))));
+		// Exactly parallel edges are skipped by the scalar version, too
+		unsure = _mm256_and_ps(greater(scale, zero), unsure);
+		if (_mm256_movemask_ps(unsure) != 0) {
+			best = _mm256_min_ps(best, _mm256_set1_ps(scalarKernel(ox, oy,
+				rx, ry, x0 + i, y0 + i, dx + i, dy + i, 8, maxDist)));
+			continue;
+		}
+		__m256 t = _mm256_div_ps(nt, denom);
+		__m256 hit = _mm256_and_ps
+			(_mm256_and_ps(greater(_mm256_mul_ps(nt, denom), zero),
+				less(t, best)),
+			 _mm256_and_ps(greater(_mm256_mul_ps(nu, denom), zero),
+				less(_mm256_mul_ps(nv, denom), zero)));
+		best = _mm256_blendv_ps(best, t, hit);
+	}
+	float lanes[8];
+	_mm256_storeu_ps(lanes, best);
+	float dist = lanes[0];
+	for (int l = 1; l < 8; l++) {
+		if (lanes[l] < dist) {
+			dist = lanes[l];
+		}
+	}
+	return scalarKernel(ox, oy, rx, ry, x0 + i, y0 + i, dx + i, dy + i,
+						n - i, dist);
+}
+
+#endif
+
+/*
+ * Integer-only kernel for fixed-point coordinates. All cross products
+ * are evaluated exactly from the raw values with 64 bit integers
+ * (coordinates of up to 2^29 in raw units, i.e. 8192 m, keep all
+ * intermediate results in range), so no case needs special treatment.
+ */
+GeometryLib::Fixed fixedKernel (GeometryLib::Fixed ox, GeometryLib::Fixed oy,
+		GeometryLib::Fixed rx, GeometryLib::Fixed ry,
+		const GeometryLib::Fixed* x0, const GeometryLib::Fixed* y0,
+		const GeometryLib::Fixed* dx, const GeometryLib::Fixed* dy,
+		size_t n, GeometryLib::Fixed maxDist) {
+	using GeometryLib::Fixed;
+	const int64_t orx = rx.raw(), ory = ry.raw();
+	const int64_t oxr = ox.raw(), oyr = oy.raw();
+	Fixed best = maxDist;
+	for (size_t i = 0; i < n; i++) {
+		int64_t ex = dx[i].raw(), ey = dy[i].raw();
+		int64_t den = orx * ey - ory * ex;
+		if (den == 0) {
+			continue;
+		}
+		int64_t wx = x0[i].raw() - oxr, wy = y0[i].raw() - oyr;
+		int64_t nu = wx * ory - wy * orx;
+		int64_t nt = wx * ey - wy * ex;
+		if (den < 0) {
+			den = -den;
+			nu = -nu;
+			nt = -nt;
+		}
+		if (nu < 0 || nu > den || nt < 0) {
+			continue;
+		}
+		Fixed t = Fixed::quotient(nt, den);
+		if (t < best) {
+			best = t;
+		}
+	}
+	return best;
+}
+
+struct Selection {
+	KernelFunc kernel;
+	FloatKernelFunc floatKernel;
+	const char* name;
+
+	Selection() : kernel(scalarKernel<double>),
+		floatKernel(scalarKernel<float>), name("scalar") {
+#ifdef RAYKERNEL_X86
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2")) {
+			kernel = avx2Kernel;
+			floatKernel = avx2FloatKernel;
+			name = "avx2";
+		} else if (__builtin_cpu_supports("sse2")) {
+			kernel = sse2Kernel;
+			floatKernel = sse2FloatKernel;
+			name = "sse2";
+		}
+#endif
+	}
+};
+
+const Selection& selection () {
+	static Selection selected;
+	return selected;
+}
+
+}
+
+double RayKernel::distance (double ox, double oy, double rx, double ry,
+		const double* x0, const double* y0, const double* dx,
+		const double* dy, size_t n, double maxDist) {
+	// Short ranges (as in tree leaves or grid cells) don't fill a vector
+	if (n < 4) {
+		return scalarKernel(ox, oy, rx, ry, x0, y0, dx, dy, n, maxDist);
+	}
+	return selection().kernel(ox, oy, rx, ry, x0, y0, dx, dy, n, maxDist);
+}
+
+float RayKernel::distance (float ox, float oy, float rx, float ry,
+		const float* x0, const float* y0, const float* dx,
+		const float* dy, size_t n, float maxDist) {
+	if (n < 4) {
+		return scalarKernel(ox, oy, rx, ry, x0, y0, dx, dy, n, maxDist);
+	}
+	return selection().floatKernel(ox, oy, rx, ry, x0, y0, dx, dy, n, maxDist);
+}
+
+GeometryLib::Fixed RayKernel::distance (GeometryLib::Fixed ox,
+		GeometryLib::Fixed oy, GeometryLib::Fixed rx, GeometryLib::Fixed ry,
+		const GeometryLib::Fixed* x0, const GeometryLib::Fixed* y0,
+		const GeometryLib::Fixed* dx, const GeometryLib::Fixed* dy,
+		size_t n, GeometryLib::Fixed maxDist) {
+	return fixedKernel(ox, oy, rx, ry, x0, y0, dx, dy, n, maxDist);
+}
+
+const char* RayKernel::implementation () {
+	return selection().name;
+}
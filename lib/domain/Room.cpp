@@ -11,29 +11,191 @@
 #include <cmath>
 #include <list>
 #include "cleanerbot/Room.h"
+#include "cleanerbot/PolygonUnion.h"
+
+Room::WallRef::WallRef(const Room* room, size_t index)
+	: room(room), index(index) {
+}
+
+size_t Room::WallRef::getIndex () const {
+	return index;
+}
+
+Wall::ShapeRange Room::WallRef::shapeRange () const {
+	return room->shapes.range(room->wallStart[index],
+							  room->wallStart[index + 1]);
+}
+
+Wall Room::WallRef::toWall () const {
+	Wall wall;
+	Wall::ShapeRange shape = shapeRange();
+	for (Wall::ShapeRange::iterator p = shape.begin(); p != shape.end(); ++p) {
+		wall.addShape(*p);
+	}
+	return wall;
+}
 
 Room::Room() {
+	accelerator = BOUNDING_VOLUMES;
+	wallStart.push_back(0);
+	outlined = true;
+	baked = false;
+	shapeEdges = 0;
 }
 
 Room::~Room() {
 }
 
 void Room::addWall (const Wall& wall) {
-	walls.push_back(wall);
+	Wall::ShapeRange shape = wall.shapeRange();
+	for (Wall::ShapeRange::iterator p = shape.begin(); p != shape.end(); ++p) {
+		shapes.add(*p);
+	}
+	wallStart.push_back(shapes.size());
+	segments.add(wall.getSegments());
+	outlined = false;
+	baked = false;
+	if (!clearanceField.empty() && !clearanceField.add(wall)) {
+		clearanceField.build(segments, shapes, clearanceField.getResolution());
+	}
+}
+
+void Room::clear () {
+	shapes.clear();
+	wallStart.resize(1);
+	segments.clear();
+	outlined = true;
+	baked = false;
+	shapeEdges = 0;
+	bvh.build(SegmentScene());
+	grid.build(SegmentScene());
+	clearanceField = ClearanceField();
+}
+
+Room::Accelerator Room::getAccelerator() const {
+	return accelerator;
+}
+
+void Room::setAccelerator(Accelerator accelerator) {
+	this->accelerator = accelerator;
+	bvh.build(SegmentScene());
+	grid.build(SegmentScene());
+	baked = false;
+}
+
+void Room::bake () {
+	if (!outlined) {
+		// Same as Wall::bake, but directly from the room's storage
+		shapeEdges = 0;
+		segments.clear();
+		for (size_t i = 0; i < wallCount(); i++) {
+			PolygonUnion polygons;
+			for (size_t p = wallStart[i]; p < wallStart[i + 1]; p++) {
+				shapeEdges += shapes[p].edgeCount();
+				polygons.add(shapes[p]);
+			}
+			polygons.outline(segments);
+		}
+		outlined = true;
+	}
+	switch (accelerator) {
+	case BOUNDING_VOLUMES:
+		bvh.build(segments);
+		break;
+	case UNIFORM_GRID:
+		grid.build(segments);
+		break;
+	default:
+		break;
+	}
+	baked = true;
+}
+
+size_t Room::getShapeEdgeCount () const {
+	return shapeEdges;
+}
+
+size_t Room::getEdgeCount () const {
+	return segments.size();
 }
 
 std::list<Wall> Room::getWalls() const {
+	std::list<Wall> walls;
+	for (size_t i = 0; i < wallCount(); i++) {
+		walls.push_back(WallRef(this, i).toWall());
+	}
 	return walls;
 }
 
-double Room::distance (const Ray2D& ray) const {
-	double minDist = std::numeric_limits<double>::max();
-	for (std::list<Wall>::const_iterator itr = walls.begin();
-		 itr != walls.end(); itr++) {
-		double dist = itr->distance(ray);
-		if (dist < minDist) {
-			minDist = dist;
+Room::WallRange Room::wallRange() const {
+	return WallRange(WallIterator(this, 0), WallIterator(this, wallCount()));
+}
+
+size_t Room::wallCount () const {
+	return wallStart.size() - 1;
+}
+
+Room::WallRef Room::operator[] (size_t index) const {
+	return WallRef(this, index);
+}
+
+Scalar Room::distance (const Ray2D& ray) const {
+	if (baked) {
+		switch (accelerator) {
+		case BOUNDING_VOLUMES:
+			return bvh.distance(ray);
+		case UNIFORM_GRID:
+			return grid.distance(ray);
+		default:
+			break;
+		}
+	}
+	return segments.distance(ray);
+}
+
+void Room::scan (const Point2D& origin, Scalar firstAngle, Scalar angleStep,
+				 size_t count, Scalar distances[]) const {
+	if (baked) {
+		switch (accelerator) {
+		case BOUNDING_VOLUMES:
+			bvh.scan(origin, firstAngle, angleStep, count, distances);
+			return;
+		case UNIFORM_GRID:
+			grid.scan(origin, firstAngle, angleStep, count, distances);
+			return;
+		default:
+			break;
+		}
+	}
+	segments.scan(origin, firstAngle, angleStep, count, distances);
+}
+
+Scalar Room::sweep (const Ray2D& path, Scalar radius, Scalar maxDist,
+				   Vector2D& normal) const {
+	if (baked) {
+		switch (accelerator) {
+		case BOUNDING_VOLUMES:
+			return bvh.sweep(path, radius, maxDist, normal);
+		case UNIFORM_GRID:
+			return grid.sweep(path, radius, maxDist, normal);
+		default:
+			break;
 		}
 	}
-	return minDist;
+	return segments.sweep(path, radius, maxDist, normal);
+}
+
+void Room::buildClearance (Scalar resolution) {
+	clearanceField.build(segments, shapes, resolution);
+}
+
+Scalar Room::clearance (const Point2D& position) const {
+	if (clearanceField.empty()) {
+		return segments.clearance(position.x(), position.y());
+	}
+	return clearanceField.clearance(position);
+}
+
+Vector2D Room::clearanceGradient (const Point2D& position) const {
+	return clearanceField.gradient(position);
 }
@@ -0,0 +1,364 @@
+/*
+ * @file SegmentBVH.cpp
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "cleanerbot/SegmentBVH.h"
+
+using namespace std;
+
+namespace {
+
+const unsigned int SAH_BINS = 16;
+const unsigned int MAX_LEAF_SIZE = 8;
+// The traversal uses a fixed size stack, so the tree depth is limited.
+const unsigned int MAX_DEPTH = 60;
+
+/*
+ * Compute the distance from the ray's origin to the point where the
+ * ray enters the given box, or infinity if the box is missed.
+ */
+inline Scalar entry (Scalar ox, Scalar oy, Scalar rx, Scalar ry,
+		             Scalar invX, Scalar invY, Scalar minX, Scalar minY,
+		             Scalar maxX, Scalar maxY) {
+	Scalar tMin = 0;
+	Scalar tMax = numeric_limits<Scalar>::infinity();
+	if (rx == 0) {
+		if (ox < minX || ox > maxX) {
+			return numeric_limits<Scalar>::infinity();
+		}
+	} else {
+		Scalar t1 = (minX - ox) * invX;
+		Scalar t2 = (maxX - ox) * invX;
+		tMin = max(tMin, min(t1, t2));
+		tMax = min(tMax, max(t1, t2));
+	}
+	if (ry == 0) {
+		if (oy < minY || oy > maxY) {
+			return numeric_limits<Scalar>::infinity();
+		}
+	} else {
+		Scalar t1 = (minY - oy) * invY;
+		Scalar t2 = (maxY - oy) * invY;
+		tMin = max(tMin, min(t1, t2));
+		tMax = min(tMax, max(t1, t2));
+	}
+	return tMin <= tMax ? tMin : numeric_limits<Scalar>::infinity();
+}
+
+/*
+ * Half the perimeter of the box (minX, minY, maxX, maxY), the cost
+ * measure of the surface area heuristic in the plane.
+ */
+inline double perimeter (const Scalar box[4]) {
+	return static_cast<double>(box[2] - box[0])
+		+ static_cast<double>(box[3] - box[1]);
+}
+
+}
+
+SegmentBVH::SegmentBVH() {
+}
+
+SegmentBVH::~SegmentBVH() {
+}
+
+size_t SegmentBVH::size () const {
+	return segments.size();
+}
+
+void SegmentBVH::updateBounds (Node& node,
+		const vector<unsigned int>& order, const SegmentScene& scene) const {
+	node.minX = node.minY = numeric_limits<Scalar>::max();
+	node.maxX = node.maxY = -numeric_limits<Scalar>::max();
+	for (unsigned int i = node.first; i < node.first + node.count; i++) {
+		unsigned int s = order[i];
+		Scalar x0 = scene.x0s[s];
+		Scalar y0 = scene.y0s[s];
+		Scalar x1 = x0 + scene.dxs[s];
+		Scalar y1 = y0 + scene.dys[s];
+		node.minX = min(node.minX, min(x0, x1));
+		node.minY = min(node.minY, min(y0, y1));
+		node.maxX = max(node.maxX, max(x0, x1));
+		node.maxY = max(node.maxY, max(y0, y1));
+	}
+}
+
+void SegmentBVH::subdivide (unsigned int nodeIdx,
+		vector<unsigned int>& order, const vector<Scalar>& cx,
+		const vector<Scalar>& cy, const SegmentScene& scene) {
+	unsigned int depth = 0;
+	// Explicit stack of (node, depth) to avoid deep recursion
+	vector<pair<unsigned int, unsigned int> > todo;
+	todo.push_back(make_pair(nodeIdx, depth));
+	while (!todo.empty()) {
+		nodeIdx = todo.back().first;
+		depth = todo.back().second;
+		todo.pop_back();
+		Node node = nodes[nodeIdx];
+		if (node.count <= 2 || depth >= MAX_DEPTH) {
+			continue;
+		}
+
+		// Bounds of the centroids determine the bins
+		Scalar cMin[2] = { numeric_limits<Scalar>::max(),
+						   numeric_limits<Scalar>::max() };
+		Scalar cMax[2] = { -numeric_limits<Scalar>::max(),
+						   -numeric_limits<Scalar>::max() };
+		for (unsigned int i = node.first; i < node.first + node.count; i++) {
+			cMin[0] = min(cMin[0], cx[order[i]]);
+			cMax[0] = max(cMax[0], cx[order[i]]);
+			cMin[1] = min(cMin[1], cy[order[i]]);
+			cMax[1] = max(cMax[1], cy[order[i]]);
+		}
+
+		// Evaluate the SAH for all bin boundaries on both axes. In two
+		// dimensions, the probability of a ray hitting a box is
+		// proportional to its perimeter. Costs are given per edge
+		// of the node, which keeps them in the range of fixed-point
+		// numbers.
+		// Costs don't depend on the coordinate type, in fixed-point
+		// the fraction of edges would saturate for large nodes
+		double bestCost = numeric_limits<double>::max();
+		int bestAxis = -1;
+		unsigned int bestSplit = 0;
+		for (int axis = 0; axis < 2; axis++) {
+			if (cMax[axis] <= cMin[axis]) {
+				continue;
+			}
+			const vector<Scalar>& c = axis == 0 ? cx : cy;
+			Scalar scale = SAH_BINS / (cMax[axis] - cMin[axis]);
+			unsigned int binCount[SAH_BINS] = { 0 };
+			Scalar binBox[SAH_BINS][4];
+			for (unsigned int b = 0; b < SAH_BINS; b++) {
+				binBox[b][0] = binBox[b][1] = numeric_limits<Scalar>::max();
+				binBox[b][2] = binBox[b][3] = -numeric_limits<Scalar>::max();
+			}
+			for (unsigned int i = node.first;
+				 i < node.first + node.count; i++) {
+				unsigned int s = order[i];
+				unsigned int b = min(SAH_BINS - 1,
+					(unsigned int)((c[s] - cMin[axis]) * scale));
+				Scalar x0 = scene.x0s[s];
+				Scalar y0 = scene.y0s[s];
+				Scalar x1 = x0 + scene.dxs[s];
+				Scalar y1 = y0 + scene.dys[s];
+				binCount[b] += 1;
+				binBox[b][0] = min(binBox[b][0], min(x0, x1));
+				binBox[b][1] = min(binBox[b][1], min(y0, y1));
+				binBox[b][2] = max(binBox[b][2], max(x0, x1));
+				binBox[b][3] = max(binBox[b][3], max(y0, y1));
+			}
+			// Sweep from the left and from the right
+			double leftCost[SAH_BINS];
+			Scalar box[4] = { numeric_limits<Scalar>::max(),
+							  numeric_limits<Scalar>::max(),
+							  -numeric_limits<Scalar>::max(),
+							  -numeric_limits<Scalar>::max() };
+			unsigned int cnt = 0;
+			for (unsigned int b = 0; b < SAH_BINS - 1; b++) {
+				cnt += binCount[b];
+				box[0] = min(box[0], binBox[b][0]);
+				box[1] = min(box[1], binBox[b][1]);
+				box[2] = max(box[2], binBox[b][2]);
+				box[3] = max(box[3], binBox[b][3]);
+				leftCost[b] = cnt == 0 ? 0 : double(cnt) / node.count
+					* perimeter(box);
+			}
+			box[0] = box[1] = numeric_limits<Scalar>::max();
+			box[2] = box[3] = -numeric_limits<Scalar>::max();
+			cnt = 0;
+			for (unsigned int b = SAH_BINS - 1; b > 0; b--) {
+				cnt += binCount[b];
+				box[0] = min(box[0], binBox[b][0]);
+				box[1] = min(box[1], binBox[b][1]);
+				box[2] = max(box[2], binBox[b][2]);
+				box[3] = max(box[3], binBox[b][3]);
+				if (cnt == 0 || cnt == node.count) {
+					continue;
+				}
+				double cost = leftCost[b - 1] + double(cnt) / node.count
+					* perimeter(box);
+				if (cost < bestCost) {
+					bestCost = cost;
+					bestAxis = axis;
+					bestSplit = b;
+				}
+			}
+		}
+
+		double leafCost = static_cast<double>(node.maxX - node.minX)
+			+ static_cast<double>(node.maxY - node.minY);
+		if (bestAxis < 0
+			|| (bestCost >= leafCost && node.count <= MAX_LEAF_SIZE)) {
+			continue;
+		}
+
+		// Partition the edges of the node by the chosen bin boundary
+		const vector<Scalar>& c = bestAxis == 0 ? cx : cy;
+		Scalar scale = SAH_BINS / (cMax[bestAxis] - cMin[bestAxis]);
+		unsigned int lo = node.first;
+		unsigned int hi = node.first + node.count;
+		while (lo < hi) {
+			unsigned int b = min(SAH_BINS - 1,
+				(unsigned int)((c[order[lo]] - cMin[bestAxis]) * scale));
+			if (b < bestSplit) {
+				lo += 1;
+			} else {
+				swap(order[lo], order[--hi]);
+			}
+		}
+		unsigned int leftCount = lo - node.first;
+
+		Node left;
+		left.first = node.first;
+		left.count = leftCount;
+		updateBounds(left, order, scene);
+		Node right;
+		right.first = node.first + leftCount;
+		right.count = node.count - leftCount;
+		updateBounds(right, order, scene);
+
+		unsigned int leftIdx = nodes.size();
+		nodes.push_back(left);
+		nodes.push_back(right);
+		nodes[nodeIdx].first = leftIdx;
+		nodes[nodeIdx].count = 0;
+		todo.push_back(make_pair(leftIdx, depth + 1));
+		todo.push_back(make_pair(leftIdx + 1, depth + 1));
+	}
+}
+
+void SegmentBVH::build (const SegmentScene& scene) {
+	nodes.clear();
+	segments.clear();
+	size_t n = scene.size();
+	if (n == 0) {
+		return;
+	}
+	vector<unsigned int> order(n);
+	vector<Scalar> cx(n);
+	vector<Scalar> cy(n);
+	for (size_t i = 0; i < n; i++) {
+		order[i] = i;
+		cx[i] = scene.x0s[i] + scene.dxs[i] / 2;
+		cy[i] = scene.y0s[i] + scene.dys[i] / 2;
+	}
+	nodes.reserve(2 * n);
+	Node root;
+	root.first = 0;
+	root.count = n;
+	updateBounds(root, order, scene);
+	nodes.push_back(root);
+	subdivide(0, order, cx, cy, scene);
+
+	// Store the edges in leaf order
+	segments.x0s.resize(n);
+	segments.y0s.resize(n);
+	segments.dxs.resize(n);
+	segments.dys.resize(n);
+	for (size_t i = 0; i < n; i++) {
+		segments.x0s[i] = scene.x0s[order[i]];
+		segments.y0s[i] = scene.y0s[order[i]];
+		segments.dxs[i] = scene.dxs[order[i]];
+		segments.dys[i] = scene.dys[order[i]];
+	}
+}
+
+Scalar SegmentBVH::distance (const Ray2D& ray) const {
+	return traverse(ray.start().x(), ray.start().y(),
+					ray.direction().dx(), ray.direction().dy(),
+					0, numeric_limits<Scalar>::max(), NULL);
+}
+
+Scalar SegmentBVH::sweep (const Ray2D& path, Scalar radius, Scalar maxDist,
+						  Vector2D& normal) const {
+	return traverse(path.start().x(), path.start().y(),
+					path.direction().dx(), path.direction().dy(),
+					radius, maxDist, &normal);
+}
+
+/*
+ * Find the first hit of the ray (normal == NULL) or of a disc with the
+ * given radius moving along the ray. For the disc, the boxes are
+ * enlarged by the radius.
+ */
+Scalar SegmentBVH::traverse (Scalar ox, Scalar oy, Scalar rx, Scalar ry,
+		Scalar radius, Scalar maxDist, Vector2D* normal) const {
+	Scalar best = maxDist;
+	if (nodes.empty()) {
+		return best;
+	}
+	const Scalar invX = 1 / rx;
+	const Scalar invY = 1 / ry;
+
+	const Node* root = &nodes[0];
+	if (entry(ox, oy, rx, ry, invX, invY,
+			  root->minX - radius, root->minY - radius,
+			  root->maxX + radius, root->maxY + radius)
+		== numeric_limits<Scalar>::infinity()) {
+		return best;
+	}
+	unsigned int stack[MAX_DEPTH + 2];
+	Scalar stackEntry[MAX_DEPTH + 2];
+	unsigned int sp = 0;
+	unsigned int idx = 0;
+	while (true) {
+		const Node& node = nodes[idx];
+		if (node.count > 0) {
+			if (normal == NULL) {
+				best = segments.distance(ox, oy, rx, ry, node.first,
+										 node.first + node.count, best);
+			} else {
+				best = segments.sweep(ox, oy, rx, ry, radius, node.first,
+									  node.first + node.count, best, *normal);
+			}
+		} else {
+			unsigned int near = node.first;
+			unsigned int far = node.first + 1;
+			const Node& l = nodes[near];
+			const Node& r = nodes[far];
+			Scalar tNear = entry(ox, oy, rx, ry, invX, invY,
+								 l.minX - radius, l.minY - radius,
+								 l.maxX + radius, l.maxY + radius);
+			Scalar tFar = entry(ox, oy, rx, ry, invX, invY,
+								r.minX - radius, r.minY - radius,
+								r.maxX + radius, r.maxY + radius);
+			if (tFar < tNear) {
+				swap(near, far);
+				swap(tNear, tFar);
+			}
+			if (tNear < best) {
+				if (tFar < best) {
+					stack[sp] = far;
+					stackEntry[sp++] = tFar;
+				}
+				idx = near;
+				continue;
+			}
+		}
+		// Pop the next node that may still contain a closer hit
+		// (best may have improved since the node was pushed).
+		while (sp > 0 && stackEntry[sp - 1] >= best) {
+			sp -= 1;
+		}
+		if (sp == 0) {
+			break;
+		}
+		idx = stack[--sp];
+	}
+	return best;
+}
+
+void SegmentBVH::scan (const Point2D& origin, Scalar firstAngle,
+		Scalar angleStep, size_t count, Scalar distances[]) const {
+	for (size_t i = 0; i < count; i++) {
+		Scalar angle = firstAngle + i * angleStep;
+		distances[i] = traverse(origin.x(), origin.y(), cos(angle), sin(angle),
+								0, numeric_limits<Scalar>::max(), NULL);
+	}
+}
@@ -0,0 +1,333 @@
+/*
+ * @file SegmentGrid.cpp
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "cleanerbot/SegmentGrid.h"
+
+using namespace std;
+
+namespace {
+
+const int MAX_CELLS_PER_AXIS = 4096;
+const double CELLS_PER_SEGMENT = 2;
+
+/*
+ * Check if the segment (x0, y0) + u * (dx, dy), 0 <= u <= 1 touches
+ * the (closed) box.
+ */
+bool touches (Scalar x0, Scalar y0, Scalar dx, Scalar dy,
+		      Scalar minX, Scalar minY, Scalar maxX, Scalar maxY) {
+	if (max(x0, x0 + dx) < minX || min(x0, x0 + dx) > maxX
+		|| max(y0, y0 + dy) < minY || min(y0, y0 + dy) > maxY) {
+		return false;
+	}
+	// The box touches the segment's line unless all corners are
+	// strictly on the same side of it.
+	Scalar c1 = dx * (minY - y0) - dy * (minX - x0);
+	Scalar c2 = dx * (minY - y0) - dy * (maxX - x0);
+	Scalar c3 = dx * (maxY - y0) - dy * (minX - x0);
+	Scalar c4 = dx * (maxY - y0) - dy * (maxX - x0);
+	return !((c1 > 0 && c2 > 0 && c3 > 0 && c4 > 0)
+			 || (c1 < 0 && c2 < 0 && c3 < 0 && c4 < 0));
+}
+
+}
+
+SegmentGrid::SegmentGrid()
+	: minX(0), minY(0), cellWidth(1), cellHeight(1), columns(0), rows(0) {
+}
+
+SegmentGrid::~SegmentGrid() {
+}
+
+size_t SegmentGrid::cells () const {
+	return columns * rows;
+}
+
+void SegmentGrid::build (const SegmentScene& scene) {
+	cellStart.clear();
+	segments.clear();
+	columns = rows = 0;
+	size_t n = scene.size();
+	if (n == 0) {
+		return;
+	}
+
+	Scalar maxX, maxY;
+	minX = minY = numeric_limits<Scalar>::max();
+	maxX = maxY = -numeric_limits<Scalar>::max();
+	for (size_t i = 0; i < n; i++) {
+		minX = min(minX, min(scene.x0s[i], scene.x0s[i] + scene.dxs[i]));
+		minY = min(minY, min(scene.y0s[i], scene.y0s[i] + scene.dys[i]));
+		maxX = max(maxX, max(scene.x0s[i], scene.x0s[i] + scene.dxs[i]));
+		maxY = max(maxY, max(scene.y0s[i], scene.y0s[i] + scene.dys[i]));
+	}
+	// Avoid degenerate (zero width or height) grids. The margin is at
+	// least one unit of the coordinates' resolution, 1e-6 is below the
+	// resolution of fixed-point numbers.
+	double extent = max(1.0, static_cast<double>(max(maxX - minX, maxY - minY)));
+	Scalar margin = max(Scalar(1e-6 * extent),
+						numeric_limits<Scalar>::epsilon());
+	minX -= margin;
+	minY -= margin;
+	maxX += margin;
+	maxY += margin;
+
+	// The area may exceed the range of fixed-point numbers
+	double width = static_cast<double>(maxX - minX);
+	double height = static_cast<double>(maxY - minY);
+	double cellSize = sqrt(width * height / (CELLS_PER_SEGMENT * n));
+	columns = min(MAX_CELLS_PER_AXIS, max(1, (int)ceil(width / cellSize)));
+	rows = min(MAX_CELLS_PER_AXIS, max(1, (int)ceil(height / cellSize)));
+	cellWidth = Scalar(width / columns);
+	cellHeight = Scalar(height / rows);
+
+	// First pass counts the edges per cell, second pass stores them
+	cellStart.assign(columns * rows + 1, 0);
+	vector<unsigned int> fill;
+	for (int pass = 0; pass < 2; pass++) {
+		for (size_t i = 0; i < n; i++) {
+			Scalar x0 = scene.x0s[i];
+			Scalar y0 = scene.y0s[i];
+			Scalar dx = scene.dxs[i];
+			Scalar dy = scene.dys[i];
+			int c0 = max(0, (int)floor((min(x0, x0 + dx) - minX) / cellWidth));
+			int c1 = min(columns - 1,
+						 (int)floor((max(x0, x0 + dx) - minX) / cellWidth));
+			int r0 = max(0, (int)floor((min(y0, y0 + dy) - minY) / cellHeight));
+			int r1 = min(rows - 1,
+						 (int)floor((max(y0, y0 + dy) - minY) / cellHeight));
+			for (int r = r0; r <= r1; r++) {
+				for (int c = c0; c <= c1; c++) {
+					if (!touches(x0, y0, dx, dy,
+								 minX + c * cellWidth, minY + r * cellHeight,
+								 minX + (c + 1) * cellWidth,
+								 minY + (r + 1) * cellHeight)) {
+						continue;
+					}
+					int cell = r * columns + c;
+					if (pass == 0) {
+						cellStart[cell + 1] += 1;
+					} else {
+						unsigned int pos = fill[cell]++;
+						segments.x0s[pos] = x0;
+						segments.y0s[pos] = y0;
+						segments.dxs[pos] = dx;
+						segments.dys[pos] = dy;
+					}
+				}
+			}
+		}
+		if (pass == 0) {
+			for (size_t c = 1; c < cellStart.size(); c++) {
+				cellStart[c] += cellStart[c - 1];
+			}
+			fill.assign(cellStart.begin(), cellStart.end() - 1);
+			segments.x0s.resize(cellStart.back());
+			segments.y0s.resize(cellStart.back());
+			segments.dxs.resize(cellStart.back());
+			segments.dys.resize(cellStart.back());
+		}
+	}
+}
+
+Scalar SegmentGrid::distance (const Ray2D& ray) const {
+	return distance(ray.start().x(), ray.start().y(),
+					ray.direction().dx(), ray.direction().dy());
+}
+
+void SegmentGrid::scan (const Point2D& origin, Scalar firstAngle,
+		Scalar angleStep, size_t count, Scalar distances[]) const {
+	for (size_t i = 0; i < count; i++) {
+		Scalar angle = firstAngle + i * angleStep;
+		distances[i] = distance(origin.x(), origin.y(), cos(angle), sin(angle));
+	}
+}
+
+/*
+ * The cells are visited in the order in which the path's centre line
+ * passes through them (as in distance(), but the grid is conceptually
+ * extended by the radius). While the centre moves through a cell, the
+ * disc touches the cells in the bounding box of that part of the path
+ * enlarged by the radius. The centre moves monotonically, so a cell
+ * visited before is always in the previous box.
+ */
+Scalar SegmentGrid::sweep (const Ray2D& path, Scalar radius,
+		Scalar maxDist, Vector2D& normal) const {
+	Scalar best = maxDist;
+	if (columns == 0) {
+		return best;
+	}
+	const Scalar inf = numeric_limits<Scalar>::infinity();
+	const Scalar ox = path.start().x();
+	const Scalar oy = path.start().y();
+	const Scalar rx = path.direction().dx();
+	const Scalar ry = path.direction().dy();
+	const Scalar maxX = minX + columns * cellWidth;
+	const Scalar maxY = minY + rows * cellHeight;
+
+	// Clip the path against the grid's bounds enlarged by the radius
+	Scalar tEnter = 0;
+	Scalar tLeave = maxDist;
+	if (rx == 0) {
+		if (ox < minX - radius || ox > maxX + radius) {
+			return best;
+		}
+	} else {
+		Scalar t1 = (minX - radius - ox) / rx;
+		Scalar t2 = (maxX + radius - ox) / rx;
+		tEnter = max(tEnter, min(t1, t2));
+		tLeave = min(tLeave, max(t1, t2));
+	}
+	if (ry == 0) {
+		if (oy < minY - radius || oy > maxY + radius) {
+			return best;
+		}
+	} else {
+		Scalar t1 = (minY - radius - oy) / ry;
+		Scalar t2 = (maxY + radius - oy) / ry;
+		tEnter = max(tEnter, min(t1, t2));
+		tLeave = min(tLeave, max(t1, t2));
+	}
+	if (tEnter > tLeave) {
+		return best;
+	}
+
+	int col = (int)floor((ox + tEnter * rx - minX) / cellWidth);
+	int row = (int)floor((oy + tEnter * ry - minY) / cellHeight);
+	Scalar tNextCol = rx == 0 ? inf
+		: (minX + (col + (rx > 0 ? 1 : 0)) * cellWidth - ox) / rx;
+	Scalar tNextRow = ry == 0 ? inf
+		: (minY + (row + (ry > 0 ? 1 : 0)) * cellHeight - oy) / ry;
+	Scalar tDeltaCol = rx == 0 ? inf : cellWidth / abs(rx);
+	Scalar tDeltaRow = ry == 0 ? inf : cellHeight / abs(ry);
+
+	Scalar tIn = tEnter;
+	int prevC0 = 0, prevC1 = -1, prevR0 = 0, prevR1 = -1;
+	while (true) {
+		Scalar tOut = min(min(tNextCol, tNextRow), tLeave);
+		Scalar xa = ox + tIn * rx, xb = ox + tOut * rx;
+		Scalar ya = oy + tIn * ry, yb = oy + tOut * ry;
+		Scalar loX = max(minX, min(xa, xb) - radius);
+		Scalar loY = max(minY, min(ya, yb) - radius);
+		Scalar hiX = min(maxX, max(xa, xb) + radius);
+		Scalar hiY = min(maxY, max(ya, yb) + radius);
+		int c0 = 0, c1 = -1, r0 = 0, r1 = -1;
+		if (loX <= hiX && loY <= hiY) {
+			c0 = max(0, (int)floor((loX - minX) / cellWidth));
+			c1 = min(columns - 1, (int)floor((hiX - minX) / cellWidth));
+			r0 = max(0, (int)floor((loY - minY) / cellHeight));
+			r1 = min(rows - 1, (int)floor((hiY - minY) / cellHeight));
+		}
+		for (int r = r0; r <= r1; r++) {
+			for (int c = c0; c <= c1; c++) {
+				if (r >= prevR0 && r <= prevR1 && c >= prevC0 && c <= prevC1) {
+					continue;
+				}
+				int cell = r * columns + c;
+				best = segments.sweep(ox, oy, rx, ry, radius,
+									  cellStart[cell], cellStart[cell + 1],
+									  best, normal);
+			}
+		}
+		// All cells the disc touches before the centre leaves this
+		// cell have been checked.
+		if (best <= tOut || tOut >= tLeave) {
+			break;
+		}
+		prevC0 = c0;
+		prevC1 = c1;
+		prevR0 = r0;
+		prevR1 = r1;
+		tIn = tOut;
+		if (tNextCol < tNextRow) {
+			tNextCol += tDeltaCol;
+		} else {
+			tNextRow += tDeltaRow;
+		}
+	}
+	return best;
+}
+
+Scalar SegmentGrid::distance
+	(Scalar ox, Scalar oy, Scalar rx, Scalar ry) const {
+	Scalar best = numeric_limits<Scalar>::max();
+	if (columns == 0) {
+		return best;
+	}
+	const Scalar inf = numeric_limits<Scalar>::infinity();
+	const Scalar maxX = minX + columns * cellWidth;
+	const Scalar maxY = minY + rows * cellHeight;
+
+	// Clip the ray against the grid's bounds
+	Scalar tEnter = 0;
+	Scalar tLeave = inf;
+	if (rx == 0) {
+		if (ox < minX || ox > maxX) {
+			return best;
+		}
+	} else {
+		Scalar t1 = (minX - ox) / rx;
+		Scalar t2 = (maxX - ox) / rx;
+		tEnter = max(tEnter, min(t1, t2));
+		tLeave = min(tLeave, max(t1, t2));
+	}
+	if (ry == 0) {
+		if (oy < minY || oy > maxY) {
+			return best;
+		}
+	} else {
+		Scalar t1 = (minY - oy) / ry;
+		Scalar t2 = (maxY - oy) / ry;
+		tEnter = max(tEnter, min(t1, t2));
+		tLeave = min(tLeave, max(t1, t2));
+	}
+	if (tEnter > tLeave) {
+		return best;
+	}
+
+	// Initialize the cell walk (Amanatides & Woo)
+	int col = min(columns - 1, max(0,
+			(int)floor((ox + tEnter * rx - minX) / cellWidth)));
+	int row = min(rows - 1, max(0,
+			(int)floor((oy + tEnter * ry - minY) / cellHeight)));
+	int stepCol = rx > 0 ? 1 : -1;
+	int stepRow = ry > 0 ? 1 : -1;
+	Scalar tNextCol = rx == 0 ? inf
+		: (minX + (col + (rx > 0 ? 1 : 0)) * cellWidth - ox) / rx;
+	Scalar tNextRow = ry == 0 ? inf
+		: (minY + (row + (ry > 0 ? 1 : 0)) * cellHeight - oy) / ry;
+	Scalar tDeltaCol = rx == 0 ? inf : cellWidth / abs(rx);
+	Scalar tDeltaRow = ry == 0 ? inf : cellHeight / abs(ry);
+
+	while (true) {
+		int cell = row * columns + col;
+		best = segments.distance(ox, oy, rx, ry, cellStart[cell],
+								 cellStart[cell + 1], best);
+		// A hit before leaving this cell cannot be beaten by
+		// edges in cells further along the ray.
+		Scalar tCellExit = min(tNextCol, tNextRow);
+		if (best <= tCellExit) {
+			break;
+		}
+		if (tNextCol < tNextRow) {
+			col += stepCol;
+			if (col < 0 || col >= columns) {
+				break;
+			}
+			tNextCol += tDeltaCol;
+		} else {
+			row += stepRow;
+			if (row < 0 || row >= rows) {
+				break;
+			}
+			tNextRow += tDeltaRow;
+		}
+	}
+	return best;
+}
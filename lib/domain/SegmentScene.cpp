@@ -0,0 +1,246 @@
+/*
+ * @file SegmentScene.cpp
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "cleanerbot/SegmentScene.h"
+#include "cleanerbot/RayKernel.h"
+
+SegmentScene::SegmentScene() {
+}
+
+SegmentScene::~SegmentScene() {
+}
+
+void SegmentScene::add (const Segment2D& segment) {
+	x0s.push_back(segment.start().x());
+	y0s.push_back(segment.start().y());
+	dxs.push_back(segment.end().x() - segment.start().x());
+	dys.push_back(segment.end().y() - segment.start().y());
+}
+
+void SegmentScene::add (const PolygonRef& polygon) {
+	Polygon2D::EdgeRange edges = polygon.edgeRange();
+	for (Polygon2D::EdgeIterator ei = edges.begin(); ei != edges.end(); ++ei) {
+		add(*ei);
+	}
+}
+
+void SegmentScene::add (const SegmentScene& scene) {
+	x0s.insert(x0s.end(), scene.x0s.begin(), scene.x0s.end());
+	y0s.insert(y0s.end(), scene.y0s.begin(), scene.y0s.end());
+	dxs.insert(dxs.end(), scene.dxs.begin(), scene.dxs.end());
+	dys.insert(dys.end(), scene.dys.begin(), scene.dys.end());
+}
+
+void SegmentScene::clear () {
+	x0s.clear();
+	y0s.clear();
+	dxs.clear();
+	dys.clear();
+}
+
+size_t SegmentScene::size () const {
+	return x0s.size();
+}
+
+Scalar SegmentScene::distance (const Ray2D& ray) const {
+	return distance(ray.start().x(), ray.start().y(),
+					ray.direction().dx(), ray.direction().dy(),
+					0, size(), std::numeric_limits<Scalar>::max());
+}
+
+void SegmentScene::scan (const Point2D& origin, Scalar firstAngle,
+		Scalar angleStep, size_t count, Scalar distances[]) const {
+	// Overloads for the scalar type, as used by Ray2D and RayKernel
+	using std::cos;
+	using std::sin;
+	using std::abs;
+	// The angular sorting multiplies coordinates, which may exceed
+	// the range of fixed-point numbers, so these use the ray kernel.
+	if (std::numeric_limits<Scalar>::is_exact
+		|| angleStep <= 0 || angleStep * count > 2 * M_PI + angleStep) {
+		Boundary::scan(origin, firstAngle, angleStep, count, distances);
+		return;
+	}
+	// Rays are processed in chunks so that their directions
+	// fit into a buffer on the stack.
+	const size_t CHUNK = 256;
+	Scalar cs[CHUNK];
+	Scalar sn[CHUNK];
+	const Scalar ox = origin.x();
+	const Scalar oy = origin.y();
+	const Scalar eps = sqrt(std::numeric_limits<Scalar>::epsilon());
+	for (size_t c0 = 0; c0 < count; c0 += CHUNK) {
+		size_t m = std::min(CHUNK, count - c0);
+		Scalar chunkAngle = firstAngle + c0 * angleStep;
+		Scalar* out = distances + c0;
+		for (size_t k = 0; k < m; k++) {
+			// Same directions as the rays of Boundary::scan
+			cs[k] = cos(firstAngle + (c0 + k) * angleStep);
+			sn[k] = sin(firstAngle + (c0 + k) * angleStep);
+			out[k] = std::numeric_limits<Scalar>::max();
+		}
+		for (size_t i = 0; i < x0s.size(); i++) {
+			Scalar wx = x0s[i] - ox;
+			Scalar wy = y0s[i] - oy;
+			Scalar ex = dxs[i];
+			Scalar ey = dys[i];
+			// Angular range covered by the edge as seen from the
+			// origin, starting at "from" and extending counter-clockwise
+			Scalar a0 = atan2(wy, wx);
+			Scalar a1 = atan2(wy + ey, wx + ex);
+			Scalar from = a0;
+			Scalar span = a1 - a0;
+			Scalar cross = wx * ey - wy * ex;
+			if (abs(cross) <= eps * (abs(wx * ey) + abs(wy * ex))) {
+				// The origin lies (nearly) on the edge's line, possibly
+				// on the edge itself, which then blocks rays in every
+				// direction. Test all rays.
+				from = chunkAngle;
+				span = 2 * M_PI;
+			} else if (cross < 0) {
+				from = a1;
+				span = -span;
+			}
+			if (span < 0) {
+				span += 2 * M_PI;
+			}
+			Scalar rel = fmod(from - chunkAngle, 2 * M_PI);
+			if (rel < 0) {
+				rel += 2 * M_PI;
+			}
+			// The range may wrap around relative to the first ray
+			for (int wrap = 0; wrap < 2; wrap++) {
+				Scalar lo = (rel - wrap * 2 * M_PI - eps) / angleStep;
+				Scalar hi = (rel - wrap * 2 * M_PI + span + eps) / angleStep;
+				if (hi < 0 || lo > m - 1) {
+					continue;
+				}
+				size_t kFirst = lo <= 0 ? 0 : (size_t)ceil(lo);
+				size_t kLast = std::min(m - 1, (size_t)floor(hi));
+				for (size_t k = kFirst; k <= kLast; k++) {
+					// The kernel decides exactly where necessary, so
+					// the results are the same as for single rays
+					out[k] = distance(ox, oy, cs[k], sn[k], i, i + 1, out[k]);
+				}
+			}
+		}
+	}
+}
+
+Scalar SegmentScene::edgeDistance (size_t index, Scalar px, Scalar py) const {
+	Scalar wx = px - x0s[index];
+	Scalar wy = py - y0s[index];
+	Scalar length = Vector2D(Point2D(0, 0),
+							 Point2D(dxs[index], dys[index])).length();
+	if (length == 0) {
+		return Vector2D(Point2D(0, 0), Point2D(wx, wy)).length();
+	}
+	// Project onto the unit direction, this keeps all products
+	// in the range of the coordinates.
+	Scalar ux = dxs[index] / length;
+	Scalar uy = dys[index] / length;
+	Scalar along = std::max(Scalar(0), std::min(length, wx * ux + wy * uy));
+	return Vector2D(Point2D(0, 0),
+					Point2D(wx - along * ux, wy - along * uy)).length();
+}
+
+Scalar SegmentScene::sweep (const Ray2D& path, Scalar radius,
+		Scalar maxDist, Vector2D& normal) const {
+	return sweep(path.start().x(), path.start().y(),
+				 path.direction().dx(), path.direction().dy(),
+				 radius, 0, size(), maxDist, normal);
+}
+
+/*
+ * Disc: o + t*r with |r| = 1 and radius R, edge: p + a*u with unit
+ * vector u and 0 <= a <= length. The disc touches the edge either with
+ * its interior (the distance from the edge's line becomes R) or at
+ * one of the end points. All products involve at least one unit
+ * vector, so they stay in the range of the coordinates.
+ */
+Scalar SegmentScene::sweep (Scalar ox, Scalar oy, Scalar rx, Scalar ry,
+		Scalar radius, size_t first, size_t last, Scalar maxDist,
+		Vector2D& normal) const {
+	using std::abs;
+	Scalar best = maxDist;
+	for (size_t i = first; i < last; i++) {
+		Scalar wx = ox - x0s[i];
+		Scalar wy = oy - y0s[i];
+		Scalar length = Vector2D(Point2D(0, 0),
+								 Point2D(dxs[i], dys[i])).length();
+		Scalar ux = 0, uy = 0;
+		if (length > 0) {
+			ux = dxs[i] / length;
+			uy = dys[i] / length;
+		}
+		// Already overlapping: only motion away from the edge is free
+		Scalar along = wx * ux + wy * uy;
+		Scalar closest = std::max(Scalar(0), std::min(length, along));
+		Scalar cx = wx - closest * ux;
+		Scalar cy = wy - closest * uy;
+		Scalar d = Vector2D(Point2D(0, 0), Point2D(cx, cy)).length();
+		if (d < radius) {
+			if (cx * rx + cy * ry < 0) {
+				best = 0;
+				normal = d > 0 ? Vector2D(Point2D(0, 0), Point2D(cx / d, cy / d))
+					: Vector2D(Point2D(0, 0), Point2D(-rx, -ry));
+			}
+			continue;
+		}
+		// Interior of the edge
+		Scalar side = wx * uy - wy * ux;
+		Scalar approach = rx * uy - ry * ux;
+		if (length > 0 && ((side > 0 && approach < 0)
+						   || (side < 0 && approach > 0))) {
+			Scalar t = (abs(side) - radius) / abs(approach);
+			Scalar a = along + t * (rx * ux + ry * uy);
+			if (t >= 0 && t < best && a >= 0 && a <= length) {
+				best = t;
+				normal = side > 0 ? Vector2D(Point2D(0, 0), Point2D(uy, -ux))
+					: Vector2D(Point2D(0, 0), Point2D(-uy, ux));
+			}
+		}
+		// End points, using the distance h of the point from the
+		// disc's path
+		for (int end = 0; end < 2; end++) {
+			Scalar qx = end == 0 ? wx : wx - dxs[i];
+			Scalar qy = end == 0 ? wy : wy - dys[i];
+			Scalar b = qx * rx + qy * ry;
+			Scalar h = qx * ry - qy * rx;
+			if (b >= 0 || abs(h) >= radius) {
+				continue;
+			}
+			Scalar t = -b - sqrt(radius * radius - h * h);
+			if (t >= 0 && t < best) {
+				best = t;
+				normal = Vector2D(Point2D(0, 0),
+						Point2D((qx + t * rx) / radius, (qy + t * ry) / radius));
+			}
+		}
+	}
+	return best;
+}
+
+Scalar SegmentScene::clearance (Scalar px, Scalar py) const {
+	Scalar best = std::numeric_limits<Scalar>::max();
+	for (size_t i = 0; i < size(); i++) {
+		best = std::min(best, edgeDistance(i, px, py));
+	}
+	return best;
+}
+
+Scalar SegmentScene::distance (Scalar ox, Scalar oy, Scalar rx, Scalar ry,
+		size_t first, size_t last, Scalar maxDist) const {
+	if (first >= last) {
+		return maxDist;
+	}
+	return RayKernel::distance(ox, oy, rx, ry, &x0s[first], &y0s[first],
+							   &dxs[first], &dys[first], last - first, maxDist);
+}
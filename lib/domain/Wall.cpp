@@ -8,68 +8,96 @@
 
 #define _USE_MATH_DEFINES
 #include <cmath>
-#include <limits>
 #include "cleanerbot/Wall.h"
+#include "cleanerbot/PolygonUnion.h"
 
 using namespace std;
 
 Wall::Wall() {
+	baked = false;
 }
 
 Wall::Wall(const Polygon2D& shape) {
+	baked = false;
 	addShape(shape);
 }
 
-Wall::Wall(const Point2D& end1, const Point2D& end2, double thickness) {
+Wall::Wall(const Point2D& end1, const Point2D& end2, Scalar thickness) {
+	baked = false;
 	addSection(end1, end2, thickness);
 }
 
 Wall::~Wall() {
 }
 
-void Wall::addShape (const Polygon2D& shape) {
-	this->shape.push_back(shape);
+void Wall::addShape (const PolygonRef& shape) {
+	this->shape.add(shape);
+	if (baked) {
+		// Restore the edges of all polygons, bake has to be repeated
+		segments.clear();
+		for (size_t i = 0; i < this->shape.size(); i++) {
+			segments.add(this->shape[i]);
+		}
+		baked = false;
+	} else {
+		segments.add(shape);
+	}
 }
 
 void Wall::addSection (const Point2D& end1, const Point2D& end2,
-		               double thickness) {
-	Polygon2D poly; // Eventually, we want a polygon
+		               Scalar thickness) {
+	Point2D poly[4]; // Eventually, we want a polygon
     // Vector scaled to sqrt(2)*thickness/2
 	Vector2D cornerOffset
-		= Vector2D(end1, end2).scale(sqrt(thickness*thickness/2));
+		= Vector2D(end1, end2).scale(thickness * Scalar(M_SQRT1_2));
     // Rotate left 135 degrees
-	poly.add(end1 + cornerOffset.rotate(3*M_PI/4));
+	poly[0] = end1 + cornerOffset.rotate(3*M_PI/4);
 	// Now right 135 degrees
-	poly.add(end1 + cornerOffset.rotate(-3*M_PI/4));
+	poly[1] = end1 + cornerOffset.rotate(-3*M_PI/4);
 
 	// Same with other end
-	poly.add(end2 + cornerOffset.rotate(-M_PI/4));
-	poly.add(end2 + cornerOffset.rotate(M_PI/4));
+	poly[2] = end2 + cornerOffset.rotate(-M_PI/4);
+	poly[3] = end2 + cornerOffset.rotate(M_PI/4);
 
 	// Add result to shapes
-	addShape(poly);
+	addShape(PolygonRef(poly, 4));
 }
 
 std::list<Polygon2D> Wall::getShape() const {
-	return shape;
+	list<Polygon2D> res;
+	for (size_t i = 0; i < shape.size(); i++) {
+		res.push_back(shape[i].toPolygon());
+	}
+	return res;
 }
 
-double Wall::distance (const Ray2D& ray) const {
-	double dist = std::numeric_limits<double>::max();
-	for (std::list<Polygon2D>::const_iterator itr = shape.begin();
-		 itr != shape.end(); itr++) {
-		vector<Segment2D> edges = itr->edges();
-		for (vector<Segment2D>::iterator ei = edges.begin();
-			 ei != edges.end(); ei++) {
-			Point2D res(0,0);
-			if (ei->findIntersection(res, ray)) {
-				double d = Vector2D(ray.start(), res).length();
-				if (d < dist) {
-					dist = d;
-			    }
-			}
-		}
+void Wall::bake () {
+	if (baked) {
+		return;
 	}
-	return dist;
+	PolygonUnion polygons;
+	for (size_t i = 0; i < shape.size(); i++) {
+		polygons.add(shape[i]);
+	}
+	segments.clear();
+	polygons.outline(segments);
+	baked = true;
+}
+
+Wall::ShapeRange Wall::shapeRange() const {
+	return shape.range();
+}
+
+const SegmentScene& Wall::getSegments() const {
+	return segments;
+}
+
+Scalar Wall::distance (const Ray2D& ray) const {
+	return segments.distance(ray);
+}
+
+void Wall::scan (const Point2D& origin, Scalar firstAngle, Scalar angleStep,
+				 size_t count, Scalar distances[]) const {
+	segments.scan(origin, firstAngle, angleStep, count, distances);
 }
 
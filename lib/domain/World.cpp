@@ -15,6 +15,7 @@
 #include <list>
 #include <vector>
 #include <limits>
+#include <memory>
 #include "cleanerbot/World.h"
 
 #ifdef max
@@ -24,54 +25,83 @@
 using namespace std;
 
 World::World(string host, int port) {
+	sink = NULL;
 	traceCommands = false;
+	frameInterval = chrono::duration_cast<chrono::steady_clock::duration>
+		(chrono::duration<double>(1.0 / 60));
+	initShow();
+	ownsRoom = false;
 	try {
-		cmdCon = new SocketClient(host, port);
+		cmdCon = new CommandChannel(host, port);
 	} catch (string& e) {
 		cerr << "Verbindung zum Anzeige-Server kann nicht hergestellt werden: "
 			 << e << endl;
 		cmdCon = NULL;
 	}
-	refCounter = new int(1);
+	refCounter = new atomic<int>(1);
 
-	room = NULL;
 	stringstream cmd;
 	cmd << "SET NAME World@" << this;
 	sendCommand(cmd);
 }
 
+World::World(Headless headless, CommandSink* sink) {
+	this->sink = sink;
+	traceCommands = false;
+	frameInterval = chrono::duration_cast<chrono::steady_clock::duration>
+		(chrono::duration<double>(1.0 / 60));
+	initShow();
+	ownsRoom = false;
+	cmdCon = NULL;
+	refCounter = NULL;
+	if (sink != NULL) {
+		stringstream cmd;
+		cmd << "SET NAME World@" << this;
+		sendCommand(cmd);
+	}
+}
+
 World::World(const World& ref) {
-	*ref.refCounter += 1;
+	if (ref.refCounter != NULL) {
+		*ref.refCounter += 1;
+	}
 	cmdCon = ref.cmdCon;
 	refCounter = ref.refCounter;
+	sink = ref.sink;
 	traceCommands = ref.traceCommands;
-
-	room = new Room (*ref.room);
+	frameInterval = ref.frameInterval;
+	initShow();
+	room = ref.room;
+	ownsRoom = false;
+	ref.ownsRoom = false;
 }
 
 World::~World() {
-	if (room != NULL) {
-		delete room;
-	}
+	flushShow();
 	decRefCounter();
 }
 
 World& World::operator=	(const World& ref) {
-	*ref.refCounter += 1;
+	if (ref.refCounter != NULL) {
+		*ref.refCounter += 1;
+	}
+	flushShow();
 	decRefCounter();
 	cmdCon = ref.cmdCon;
 	refCounter = ref.refCounter;
+	sink = ref.sink;
 	traceCommands = ref.traceCommands;
-
-	if (room != NULL) {
-		delete room;
-		room = new Room (*ref.room);
-	}
+	frameInterval = ref.frameInterval;
+	lastShow = chrono::steady_clock::time_point();
+	room = ref.room;
+	ownsRoom = false;
+	ref.ownsRoom = false;
 	return *this;
 }
 
 void World::decRefCounter() {
-	if (--(*refCounter) == 0) {
+	// Headless worlds have no connection and no counter
+	if (refCounter != NULL && --(*refCounter) == 0) {
 		sendCommand("CLOSE");
 		delete cmdCon;
 		cmdCon = NULL;
@@ -86,94 +116,145 @@ bool World::getTraceCommands () {
 
 void World::setTraceCommands (bool trace) {
 	traceCommands = trace;
+	if (cmdCon != NULL) {
+		cmdCon->setTraceResponses(trace);
+	}
 }
 
-int World::sendCommand(const string& cmd, string& rest) {
-	if (cmdCon == NULL) {
-		return 0;
+bool World::hasReceiver () const {
+	return cmdCon != NULL || sink != NULL;
+}
+
+/*
+ * Whether commands are encoded directly into the channel's buffer.
+ * When tracing, they are built as text first so that they can be
+ * logged.
+ */
+bool World::postsDirectly () const {
+	return cmdCon != NULL && !traceCommands;
+}
+
+void World::sendCommand(const string& cmd) {
+	if (!hasReceiver()) {
+		return;
 	}
+	// Keep the order of the robot's display updates and other commands
+	flushShow();
 	if (traceCommands) {
 		cerr << cmd << endl;
 	}
-	string s = cmd + "\r\n";
-	if (cmdCon->SendBytes(s) < 0) {
-		throw ios_base::failure("Verbindung zum Server verloren");
-	}
-	while (true) {
-	    string response = cmdCon->ReceiveLine();
-	    if (response.size() == 0) {
-	    	throw ios_base::failure("Verbindung zum Server verloren");
-	    }
-	    size_t eol = response.find_first_of("\r\n");
-	    if(eol >= 0) {
-	        response = response.substr(0, eol);
-	    }
-	    if(traceCommands) {
-	        cerr << response << endl;
-	    }
-	    if(response.size() > 4){
-	        rest = response.substr(4);
-	    } else {
-	        rest = "";
-	    }
-	    int resCode = atoi(response.substr(0,3).c_str());
-	    if (resCode / 100 != 1) {
-	    	return resCode;
-	    }
-	}
-}
-
-int World::sendCommand(const string& cmd) {
-	string s;
-	return sendCommand(cmd, s);
-}
-
-int World::sendCommand(stringstream& cmd, string& rest) {
-	int result = sendCommand(cmd.str(), rest);
+	if (cmdCon == NULL) {
+		sink->command(cmd);
+		return;
+	}
+	cmdCon->post(cmd);
+}
+
+void World::sendCommand(stringstream& cmd) {
+	sendCommand(cmd.str());
 	cmd.str("");
 	cmd.clear();
-	return result;
 }
 
-int World::sendCommand(stringstream& cmd) {
-	string s;
-	return sendCommand(cmd, s);
-}
+namespace {
 
-string World::getKey() {
-	string s;
-	int returnCode = sendCommand("GET KEY", s);
-	if (returnCode / 100 == 2) {
+	/*
+	 * Extract the key from the (quoted) text of the response to GET KEY.
+	 */
+	string keyFromResponse(const CommandResponse& response) {
+		if (response.code / 100 != 2) {
+			return "";
+		}
+		const string& s = response.rest;
 		int last = s.length() - 1;
-		while (s[last] != '"') {
+		while (last > 0 && s[last] != '"') {
 			last -= 1;
 		}
+		if (last <= 0) {
+			return "";
+		}
 		return s.substr(1, last - 1);
 	}
-	return "";
+
+}
+
+future<string> World::getKeyAsync() {
+	if (cmdCon == NULL) {
+		// Headless: nobody can press a key
+		sendCommand("GET KEY");
+		promise<string> none;
+		none.set_value("");
+		return none.get_future();
+	}
+	flushShow();
+	if (traceCommands) {
+		cerr << "GET KEY" << endl;
+	}
+	return async(launch::deferred, [] (future<CommandResponse> response) {
+		return keyFromResponse(response.get());
+	}, cmdCon->request("GET KEY"));
+}
+
+string World::getKey() {
+	return getKeyAsync().get();
 }
 
 void World::setRoom(const Room& newRoom) {
-	room = new Room(newRoom);
+	shared_ptr<Room> baked = make_shared<Room>(newRoom);
+	baked->bake();
+	room = baked;
+	ownsRoom = true;
+	sendScene();
+}
+
+void World::addWall(const Wall& wall) {
+	Room& modified = modifiableRoom();
+	modified.addWall(wall);
+	modified.bake();
+	sendScene();
+}
+
+shared_ptr<const Room> World::getRoom() const {
+	ownsRoom = false;
+	return room;
+}
+
+/*
+ * Return the room for modification. If the room has ever been shared
+ * with other worlds (or snapshots obtained with getRoom), this world
+ * switches to a copy of its own first. The use count can't be used for
+ * this decision, other threads may be copying or releasing the room.
+ */
+Room& World::modifiableRoom() {
+	if (!room) {
+		room = make_shared<Room>();
+	} else if (!ownsRoom) {
+		room = make_shared<Room>(*room);
+	}
+	ownsRoom = true;
+	// All rooms are created by this class as non-const objects
+	return const_cast<Room&>(*room);
+}
+
+void World::sendScene() {
+	if (!hasReceiver()) {
+		return;
+	}
 	// Raster erzeugen
 	sendCommand("START SCENE");
 	// Wände senden
-	list<Wall> walls = room->getWalls();
-	for (list<Wall>::const_iterator wall = walls.begin();
+	Room::WallRange walls = room->wallRange();
+	for (Room::WallRange::iterator wall = walls.begin();
 		 wall != walls.end(); wall++) {
-		list<Polygon2D> polies = wall->getShape();
-		for (list<Polygon2D>::const_iterator
+		Wall::ShapeRange polies = wall->shapeRange();
+		for (Wall::ShapeRange::iterator
 			 poly = polies.begin(); poly != polies.end(); poly++) {
-			stringstream cmd;
-			cmd << "WALL ";
-			const vector<Point2D> vertices = poly->vertices();
-			for (vector<Point2D>::const_iterator vi = vertices.begin();
-				 vi != vertices.end(); vi++) {
-				if (vi != vertices.begin()) {
-					cmd << ";";
-				}
-				cmd << vi->x() << "," << vi->y();
+			if (postsDirectly()) {
+				cmdCon->postWall(*poly);
+				continue;
 			}
+			string cmd;
+			CommandEncoder(cmd, CommandEncoder::PLAIN).wall(*poly);
 			sendCommand(cmd);
 		}
 	}
@@ -181,51 +262,166 @@ void World::setRoom(const Room& newRoom) {
 	sendCommand("END SCENE");
 }
 
-double World::distToRoom (const Ray2D& ray) const {
-	double dist = numeric_limits<double>::max();
-	if (room == NULL) {
-		return dist;
-	}
-	list<Wall> walls = room->getWalls();
-	for (list<Wall>::const_iterator itr = walls.begin();
-		 itr != walls.end(); itr++) {
-		double d = itr->distance(ray);
-		if (d < dist) {
-			dist = d;
-		}
+Scalar World::distToRoom (const Ray2D& ray) const {
+	if (!room) {
+		return numeric_limits<Scalar>::max();
 	}
-	return dist;
+	return room->distance(ray);
 }
 
-double World::distanceFront
-	(double positionX, double positionY, double angle, double diameter) const {
+Scalar World::distanceFront
+	(Scalar positionX, Scalar positionY, Scalar angle, Scalar diameter) const {
 	Ray2D position (Point2D(positionX, positionY), angle);
 	return distToRoom(position) - diameter/2;
 }
 
-double World::distanceLeft
-	(double positionX, double positionY, double angle, double diameter) const {
+Scalar World::distanceLeft
+	(Scalar positionX, Scalar positionY, Scalar angle, Scalar diameter) const {
 	Ray2D posLeft (Point2D(positionX, positionY), angle + M_PI/2);
 	return distToRoom(posLeft) - diameter/2;
 }
 
-double World::distanceRight
-	(double positionX, double positionY, double angle, double diameter) const {
+Scalar World::distanceRight
+	(Scalar positionX, Scalar positionY, Scalar angle, Scalar diameter) const {
 	Ray2D posRight (Point2D(positionX, positionY), angle - M_PI/2);
 	return distToRoom(posRight) - diameter/2;
 }
 
-void World::show
+void World::scan (Scalar positionX, Scalar positionY, Scalar angle,
+		Scalar fov, int nRays, Scalar distances[], Scalar diameter) const {
+	if (nRays <= 0) {
+		return;
+	}
+	Scalar step = fov / nRays;
+	if (!room) {
+		for (int i = 0; i < nRays; i++) {
+			distances[i] = numeric_limits<Scalar>::max();
+		}
+	} else {
+		room->scan(Point2D(positionX, positionY),
+				   angle - fov / 2 + step / 2, step, nRays, distances);
+	}
+	for (int i = 0; i < nRays; i++) {
+		distances[i] -= diameter / 2;
+	}
+}
+
+Scalar World::sweep (Scalar positionX, Scalar positionY, Scalar angle,
+		Scalar distance, Vector2D& normal, Scalar diameter) const {
+	if (!room) {
+		return distance;
+	}
+	Ray2D path (Point2D(positionX, positionY), angle);
+	return room->sweep(path, diameter / 2, distance, normal);
+}
+
+Scalar World::clearance
+	(Scalar positionX, Scalar positionY, Scalar diameter) const {
+	if (!room) {
+		return numeric_limits<Scalar>::max();
+	}
+	return room->clearance(Point2D(positionX, positionY)) - diameter / 2;
+}
+
+Vector2D World::clearanceGradient (Scalar positionX, Scalar positionY) const {
+	if (!room) {
+		return Vector2D(Point2D(0, 0), Point2D(0, 0));
+	}
+	return room->clearanceGradient(Point2D(positionX, positionY));
+}
+
+void World::initShow() {
+	lastShow = chrono::steady_clock::time_point();
+	showPending = false;
+	showsSent = 0;
+	showsCoalesced = 0;
+}
+
+void World::sendShow
 	(double positionX, double positionY, double angle, double diameter) {
-	stringstream cmd;
-	cmd << "VACUUM CLEANER "
-		<< positionX << ","
-		<< positionY << ";"
-		<< cos(angle) << "," << sin(angle) << ";"
-		<< diameter;
+	showsSent += 1;
+	if (postsDirectly()) {
+		cmdCon->postShow(positionX, positionY, angle, diameter);
+		return;
+	}
+	string cmd;
+	CommandEncoder(cmd, CommandEncoder::PLAIN)
+		.show(positionX, positionY, angle, diameter);
 	sendCommand(cmd);
 }
 
+void World::show
+	(double positionX, double positionY, double angle, double diameter) {
+	if (!hasReceiver()) {
+		return;
+	}
+	if (postsDirectly()) {
+		// The channel's I/O thread sends the last position of a
+		// frame when the frame ends
+		if (cmdCon->postShow(positionX, positionY, angle, diameter,
+							 frameInterval)) {
+			showsSent += 1;
+		} else {
+			showsCoalesced += 1;
+		}
+		return;
+	}
+	if (showPending) {
+		// Superseded by this call
+		showPending = false;
+		showsCoalesced += 1;
+	}
+	chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	if (now - lastShow < frameInterval) {
+		showPending = true;
+		pendingX = positionX;
+		pendingY = positionY;
+		pendingAngle = angle;
+		pendingDiameter = diameter;
+		return;
+	}
+	lastShow = now;
+	sendShow(positionX, positionY, angle, diameter);
+}
+
+void World::flushShow() {
+	if (cmdCon != NULL) {
+		cmdCon->flushShow();
+	}
+	if (!showPending) {
+		return;
+	}
+	showPending = false;
+	lastShow = chrono::steady_clock::now();
+	sendShow(pendingX, pendingY, pendingAngle, pendingDiameter);
+}
+
+void World::setDisplayRate(double framesPerSecond) {
+	flushShow();
+	if (framesPerSecond <= 0) {
+		frameInterval = chrono::steady_clock::duration::zero();
+	} else {
+		frameInterval = chrono::duration_cast<chrono::steady_clock::duration>
+			(chrono::duration<double>(1 / framesPerSecond));
+	}
+}
+
+unsigned long World::getShowsSent() const {
+	return showsSent;
+}
+
+unsigned long World::getShowsCoalesced() const {
+	return showsCoalesced;
+}
+
 void World::showStatus (string statusText) {
+	if (!hasReceiver()) {
+		return;
+	}
+	if (postsDirectly()) {
+		flushShow();
+		cmdCon->post("STATUSLINE ", statusText);
+		return;
+	}
 	sendCommand("STATUSLINE " + statusText);
 }
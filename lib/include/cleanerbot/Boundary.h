@@ -9,6 +9,7 @@
 #ifndef BOUNDARY_H_
 #define BOUNDARY_H_
 
+#include <cstddef>
 #include "Geometry.h"
 
 /**
@@ -24,7 +25,23 @@ public:
 	 * Bestimmt die Entfernung zwischen dem Ausgangspunkt eines Strahls und
 	 * dem Schnittpunkt des Strahls mit diesem begrenzenden Objekt.
 	 */
-	virtual double distance (const Ray2D& ray) const = 0;
+	virtual Scalar distance (const Ray2D& ray) const = 0;
+
+	/**
+	 * Bestimmt fr einen Fcher von <code>count</code> Strahlen, die vom
+	 * Punkt <code>origin</code> ausgehen, jeweils die Entfernung bis zum
+	 * Schnittpunkt mit diesem begrenzenden Objekt. Der Strahl mit dem
+	 * Index i hat den Winkel <code>firstAngle + i * angleStep</code>
+	 * zur x-Achse. Die Ergebnisse werden in das vom Aufrufer
+	 * bereitgestellte Feld <code>distances</code> geschrieben.
+	 *
+	 * Die Vorgabe-Implementierung ruft #distance fr jeden Strahl auf.
+	 * Abgeleitete Klassen knnen die fr alle Strahlen gemeinsamen
+	 * Berechnungen zusammenfassen.
+	 */
+	virtual void scan (const Point2D& origin, Scalar firstAngle,
+			           Scalar angleStep, size_t count,
+			           Scalar distances[]) const;
 };
 
 #endif /* BOUNDARY_H_ */
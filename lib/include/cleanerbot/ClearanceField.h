@@ -0,0 +1,111 @@
+/*
+ * @file ClearanceField.h
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#ifndef CLEARANCEFIELD_H_
+#define CLEARANCEFIELD_H_
+
+#include <vector>
+#include "cleanerbot/Wall.h"
+#include "cleanerbot/SegmentScene.h"
+
+/**
+ * Diese Klasse beschreibt ein Abstandsfeld (signed distance field) fr
+ * eine Menge von Wnden. Fr die Punkte eines gleichmigen Gitters wird
+ * der Abstand zur nchsten Kante einer Wand vorab berechnet. Punkte
+ * innerhalb einer Wand erhalten einen negativen Abstand.
+ *
+ * Der Aufbau verwendet eine euklidische Distanztransformation mit
+ * linearem Aufwand (P. F. Felzenszwalb, D. P. Huttenlocher, "Distance
+ * Transforms of Sampled Functions", 2012), deren Durchlufe ber Spalten
+ * und Zeilen auf mehrere Threads verteilt werden. Die Transformation
+ * ordnet jedem Gitterpunkt eine Kante zu, die anschlieend mit den
+ * Kanten der Nachbarpunkte verglichen und ggf. ersetzt wird. Der
+ * gespeicherte Abstand zu der gefundenen Kante ist exakt.
+ *
+ * Abfragen von Abstand und Gradient interpolieren bilinear zwischen den
+ * vier umgebenden Gitterpunkten und haben daher konstanten Aufwand. Der
+ * Fehler ist kleiner als die Auflsung des Gitters.
+ *
+ * Wird eine Wand hinzugefgt, die innerhalb des Gitters liegt, werden nur
+ * die Gitterpunkte neu berechnet, denen die neue Wand nher ist (#add).
+ */
+class ClearanceField {
+private:
+	Scalar minX, minY;
+	Scalar resolution;
+	int columns, rows;
+	SegmentScene segments;
+	// Signed distance and nearest edge (or -1) for each grid point
+	std::vector<Scalar> values;
+	std::vector<int> features;
+	std::vector<unsigned char> inside;
+
+	Point2D sample (int column, int row) const;
+	void seed (size_t edge, std::vector<int>& queue);
+	void markInside (const PolygonArena::Range& shapes,
+			         std::vector<int>& flipped);
+	void transform (const std::vector<int>& seeds);
+	void propagate (std::vector<int>& queue);
+	Scalar interpolate (const Point2D& position, Scalar& gradX,
+			            Scalar& gradY) const;
+
+public:
+	/**
+	 * Erzeugt ein leeres Abstandsfeld.
+	 */
+	ClearanceField();
+	virtual ~ClearanceField();
+
+	/**
+	 * Baut das Abstandsfeld fr Wnde mit den bergebenen Kanten und
+	 * Polygonen mit der angegebenen Auflsung (Abstand der Gitterpunkte
+	 * in Metern) auf. Ein eventuell vorher aufgebautes Feld wird dabei
+	 * verworfen. Das Gitter berdeckt die Kanten mit einem kleinen Rand.
+	 * Wrde es mehr als 4 Millionen Punkte umfassen, wird die Auflsung
+	 * entsprechend verringert.
+	 */
+	void build (const SegmentScene& edges, const PolygonArena& shapes,
+			    Scalar resolution = 0.05);
+
+	/**
+	 * Fgt die bergebene Wand zu einem aufgebauten Abstandsfeld hinzu.
+	 * Ausgehend von der neuen Wand werden nur die Gitterpunkte neu
+	 * berechnet, denen sie nher ist als die bisher nchste Kante.
+	 * Liegt die Wand nicht vollstndig im Gitter oder ist das Feld
+	 * nicht aufgebaut, wird das Feld nicht verndert und
+	 * <code>false</code> zurckgeliefert. Es muss dann mit #build neu
+	 * aufgebaut werden.
+	 */
+	bool add (const Wall& wall);
+
+	/**
+	 * Liefert <code>true</code>, wenn das Feld nicht aufgebaut ist.
+	 */
+	bool empty () const;
+
+	/**
+	 * Liefert die Auflsung des Gitters.
+	 */
+	Scalar getResolution () const;
+
+	/**
+	 * Liefert den Abstand der bergebenen Position von der nchsten
+	 * Wand (negativ innerhalb einer Wand). Fr Positionen auerhalb des
+	 * Gitters wird der Abstand zu der Kante berechnet, die dem nchsten
+	 * Randpunkt am nchsten ist. Ist das Feld leer, wird der grte
+	 * darstellbare Wert zurckgeliefert.
+	 */
+	Scalar clearance (const Point2D& position) const;
+
+	/**
+	 * Liefert den Gradienten des Abstands an der bergebenen Position,
+	 * d.&nbsp;h. (nherungsweise) den Einheitsvektor, der von der nchsten
+	 * Wand weg zeigt.
+	 */
+	Vector2D gradient (const Point2D& position) const;
+};
+
+#endif /* CLEARANCEFIELD_H_ */
@@ -0,0 +1,220 @@
+/*
+ * @file CommandChannel.h
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#ifndef COMMANDCHANNEL_H_
+#define COMMANDCHANNEL_H_
+
+#include <string>
+#include <deque>
+#include <memory>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+#include "cleanerbot/CommandEncoder.h"
+#include "../util/Socket.h"
+
+/**
+ * Die Antwort des Anzeige-Servers auf ein Kommando.
+ */
+struct CommandResponse {
+	/** Der dreistellige Antwortcode. */
+	int code;
+	/** Der Text nach dem Antwortcode. */
+	std::string rest;
+};
+
+/**
+ * Diese Klasse ist eine Verbindung zum Anzeige-Server, ber die Kommandos
+ * ohne Warten auf die Antwort gesendet werden knnen (pipelining).
+ *
+ * Die Kommandos werden mit einem CommandEncoder direkt in den
+ * Sendepuffer der Verbindung geschrieben, der von einem eigenen
+ * Ein-/Ausgabe-Thread abgearbeitet wird. Der Thread sendet alle bis
+ * dahin eingereihten Kommandos mit einem einzigen Aufruf und liest danach
+ * die Antworten, die der Server in der Reihenfolge der Kommandos liefert.
+ * Whrend er auf die Antworten wartet, knnen bereits weitere Kommandos
+ * eingereiht werden. Der Aufrufer wartet damit nicht mehr fr jedes
+ * Kommando auf einen vollstndigen Umlauf zum Server.
+ *
+ * Wird die Antwort auf ein Kommando bentigt, liefert #request ein
+ * <code>std::future</code>, das die Antwort enthlt, sobald sie
+ * eingetroffen ist. Damit die Warteschlange nicht unbegrenzt wchst,
+ * wartet der Aufrufer, wenn bereits #MAX_PENDING Kommandos ausstehen.
+ *
+ * Beim Verbindungsaufbau wird mit dem Kommando
+ * <code>PROTOCOL BINARY</code> ein binres Protokoll angefordert.
+ * Besttigt der Server das Kommando mit einem Code 2xx, werden danach in
+ * beiden Richtungen nur noch Rahmen bertragen. Ein Rahmen besteht aus
+ * seiner Lnge (ohne die Lngenangabe selbst) als vorzeichenlose
+ * 32-Bit-Zahl, dem Typ (s. CommandEncoder#FrameType) als ein Byte und
+ * den Nutzdaten. Alle Zahlen sind little-endian, Koordinaten werden als
+ * <code>float</code> (IEEE 754, 32 Bit) bertragen. Erfolgreich
+ * bearbeitete Kommandos besttigt der Server gesammelt mit
+ * CommandEncoder#FRAME_ACK. Server, die das Kommando nicht kennen,
+ * beantworten es mit einem Fehlercode, die Verbindung verwendet dann
+ * weiter das Textprotokoll.
+ *
+ * Mit #postShow(double, double, double, double, Clock::duration) kann
+ * die Anzeige eines Staubsaugers auf eine bestimmte Rate begrenzt
+ * werden. Innerhalb eines Bilds wird nur die letzte Position gemerkt,
+ * die der Ein-/Ausgabe-Thread sptestens am Ende des Bilds sendet.
+ *
+ * Alle Methoden drfen gleichzeitig aus verschiedenen Threads aufgerufen
+ * werden.
+ */
+class CommandChannel {
+public:
+	typedef std::chrono::steady_clock Clock;
+
+private:
+	// A caller waiting for the response to the command with number seq
+	struct Waiter {
+		uint64_t seq;
+		std::unique_ptr<std::promise<CommandResponse> > result;
+	};
+
+	SocketClient socket;
+	bool binary;
+	// Encoded commands not yet taken by the I/O thread. The buffer
+	// is swapped with the I/O thread's send buffer, so both keep their
+	// capacity and posting a command does not allocate memory.
+	std::string outgoing;
+	std::deque<Waiter> waiters;
+	// Commands are numbered in the order they are posted
+	uint64_t posted;
+	uint64_t taken;
+	uint64_t answered;
+	bool stopping;
+	bool failed;
+	std::atomic<bool> traceResponses;
+	// Rate limited display of the robot: the last position posted
+	// within the current frame and when it is due
+	Clock::time_point lastShow;
+	Clock::time_point showDue;
+	bool showPending;
+	double pendingX, pendingY, pendingAngle, pendingDiameter;
+	std::mutex queueMutex;
+	std::condition_variable queued;
+	std::condition_variable progress;
+	std::thread ioThread;
+
+	CommandEncoder::Format format () const;
+	std::unique_lock<std::mutex> beginPost ();
+	void endPost (std::unique_lock<std::mutex>& lock);
+	void postPendingShow ();
+	void run ();
+	bool receive (CommandResponse& response);
+	bool receive (uint64_t& next, std::deque<Waiter>& batchWaiters);
+	void complete (uint64_t seq, std::deque<Waiter>& batchWaiters,
+				   const CommandResponse& response);
+	void traceResponse (const CommandResponse& response);
+
+public:
+	/**
+	 * Die Anzahl der ausstehenden Kommandos, ab der #post und #request
+	 * warten.
+	 */
+	static const size_t MAX_PENDING = 4096;
+
+	/**
+	 * Baut eine Verbindung zum Anzeige-Server auf dem angegebenen Rechner
+	 * und Port auf und startet den Ein-/Ausgabe-Thread. Kann die
+	 * Verbindung nicht aufgebaut werden, wird (wie von SocketClient)
+	 * eine Zeichenkette mit der Fehlermeldung geworfen.
+	 *
+	 * @param host der Rechner des Anzeige-Servers.
+	 * @param port der Port des Anzeige-Servers.
+	 * @param tryBinary <code>true</code>, wenn das binre Protokoll
+	 * angefordert werden soll.
+	 */
+	CommandChannel(const std::string& host, int port, bool tryBinary = true);
+
+	/**
+	 * Wartet, bis alle ausstehenden Kommandos beantwortet sind, beendet
+	 * den Ein-/Ausgabe-Thread und schliet die Verbindung.
+	 */
+	virtual ~CommandChannel();
+
+	/**
+	 * Reiht das Kommando (ohne Zeilenende) zum Senden ein, ohne auf
+	 * die Antwort zu warten.
+	 *
+	 * @throws std::ios_base::failure wenn die Verbindung zum Server
+	 * verloren wurde.
+	 */
+	void post (const std::string& cmd);
+
+	/**
+	 * Reiht das aus <code>cmd</code> und <code>argument</code>
+	 * bestehende Kommando (s. CommandEncoder#text) zum Senden ein, ohne
+	 * auf die Antwort zu warten.
+	 */
+	void post (const char* cmd, const std::string& argument);
+
+	/**
+	 * Reiht das Kommando (ohne Zeilenende) zum Senden ein und liefert
+	 * die sptere Antwort. Geht die Verbindung verloren, bevor die
+	 * Antwort eintrifft, wirft <code>get()</code> eine
+	 * <code>std::ios_base::failure</code>.
+	 */
+	std::future<CommandResponse> request (const std::string& cmd);
+
+	/**
+	 * Liefert <code>true</code>, wenn der Server das binre Protokoll
+	 * untersttzt.
+	 */
+	bool isBinary () const;
+
+	/**
+	 * Reiht die Anzeige eines Staubsaugers (s. World#show) zum Senden
+	 * ein.
+	 */
+	void postShow (double positionX, double positionY, double angle,
+				   double diameter);
+
+	/**
+	 * Reiht die Anzeige eines Staubsaugers ein, sendet dabei aber
+	 * hchstens ein Kommando pro <code>interval</code>. Erfolgt der
+	 * Aufruf innerhalb dieser Zeit nach der letzten Anzeige, wird die
+	 * Position nur gemerkt (und ersetzt eine bereits gemerkte). Der
+	 * Ein-/Ausgabe-Thread sendet die gemerkte Position, sobald das
+	 * Intervall abgelaufen ist, auch wenn keine weiteren Aufrufe
+	 * erfolgen.
+	 *
+	 * @return <code>false</code>, wenn die Position eine noch nicht
+	 * gesendete Position ersetzt hat.
+	 */
+	bool postShow (double positionX, double positionY, double angle,
+				   double diameter, Clock::duration interval);
+
+	/**
+	 * Sendet die mit #postShow(double, double, double, double,
+	 * Clock::duration) gemerkte Position sofort.
+	 */
+	void flushShow ();
+
+	/**
+	 * Reiht eine Wand mit dem bergebenen Umriss zum Senden ein.
+	 */
+	void postWall (const PolygonRef& polygon);
+
+	/**
+	 * Wartet, bis alle bisher eingereihten Kommandos beantwortet sind.
+	 */
+	void flush ();
+
+	/**
+	 * Schaltet die Protokollierung der empfangenen Antworten ein
+	 * oder aus.
+	 */
+	void setTraceResponses (bool trace);
+};
+
+#endif /* COMMANDCHANNEL_H_ */
@@ -0,0 +1,137 @@
+/*
+ * @file CommandEncoder.h
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#ifndef COMMANDENCODER_H_
+#define COMMANDENCODER_H_
+
+#include <string>
+#include <stdint.h>
+#include "cleanerbot/PolygonArena.h"
+
+/**
+ * Diese Klasse erzeugt die Kommandos an den Anzeige-Server und hngt sie
+ * an einen vorhandenen Puffer an, ohne dafr Zwischenergebnisse
+ * (z.&nbsp;B. einen <code>std::stringstream</code>) anzulegen.
+ *
+ * Zahlen werden mit <code>std::to_chars</code> in ihrer krzesten
+ * Darstellung formatiert, aus der sich beim Einlesen wieder genau
+ * derselbe Wert ergibt. Die Formatierung erfolgt in einem Feld fester
+ * Gre auf dem Stack. Wird derselbe Puffer (z.&nbsp;B. der Sendepuffer
+ * einer Verbindung) wiederverwendet, erfolgen damit nach kurzer Zeit
+ * keine Speicheranforderungen mehr.
+ *
+ * Je nach #Format werden die Kommandos ohne Zeilenende (z.&nbsp;B. fr
+ * einen CommandSink), als Zeilen des Textprotokolls oder als Rahmen des
+ * binren Protokolls (s. CommandChannel) erzeugt. Fr die Gegenseite
+ * (s. DisplayServer) werden auch die Antworten erzeugt.
+ */
+class CommandEncoder {
+public:
+	/**
+	 * Die Form, in der die Kommandos erzeugt werden.
+	 */
+	enum Format {
+		/** Kommando ohne Zeilenende. */
+		PLAIN,
+		/** Kommando mit Zeilenende (CR LF) fr das Textprotokoll. */
+		LINE,
+		/** Rahmen des binren Protokolls. */
+		FRAME
+	};
+
+	/**
+	 * Die Typen der Rahmen des binren Protokolls.
+	 */
+	enum FrameType {
+		/** Ein Kommando des Textprotokolls (ohne Zeilenende). */
+		FRAME_TEXT = 0x01,
+		/**
+		 * Die Anzeige eines Staubsaugers (wie
+		 * <code>VACUUM CLEANER</code>): x, y, cos, sin und Durchmesser.
+		 */
+		FRAME_SHOW = 0x02,
+		/**
+		 * Eine Wand (wie <code>WALL</code>): die Anzahl der Ecken
+		 * (32 Bit) und fr jede Ecke x und y.
+		 */
+		FRAME_WALL = 0x03,
+		/**
+		 * Vom Server: die Anzahl (32 Bit) der erfolgreich bearbeiteten
+		 * Kommandos, die damit beantwortet sind.
+		 */
+		FRAME_ACK = 0x81,
+		/**
+		 * Vom Server: die Antwort auf ein einzelnes Kommando mit dem
+		 * Antwortcode (16 Bit) und dem Text nach dem Code.
+		 */
+		FRAME_RESPONSE = 0x82
+	};
+
+private:
+	std::string& buffer;
+	Format format;
+	size_t frameStart;
+
+	void begin (FrameType type);
+	void end ();
+	void number (double value);
+	void number (float value);
+	void uint32 (uint32_t value);
+	void float32 (double value);
+
+public:
+	/**
+	 * Erzeugt einen Encoder, der Kommandos in der angegebenen Form an
+	 * den bergebenen Puffer anhngt.
+	 */
+	CommandEncoder(std::string& buffer, Format format);
+	virtual ~CommandEncoder();
+
+	/**
+	 * Hngt ein beliebiges Kommando an.
+	 */
+	void text (const std::string& cmd);
+
+	/**
+	 * Hngt ein Kommando an, das aus <code>cmd</code> und
+	 * <code>argument</code> besteht (z.&nbsp;B. "STATUSLINE " und
+	 * der Text der Statuszeile).
+	 */
+	void text (const char* cmd, const std::string& argument);
+
+	/**
+	 * Hngt das Kommando zur Anzeige eines Staubsaugers an
+	 * (s. World#show).
+	 */
+	void show (double positionX, double positionY, double angle,
+			   double diameter);
+
+	/**
+	 * Hngt das Kommando zur Anzeige einer Wand mit dem bergebenen
+	 * Umriss an.
+	 */
+	void wall (const PolygonRef& polygon);
+
+	/**
+	 * Hngt die Antwort mit dem angegebenen Code und Text an (als Zeile
+	 * oder als Rahmen #FRAME_RESPONSE).
+	 */
+	void response (int code, const std::string& rest);
+
+	/**
+	 * Hngt die gesammelte Besttigung der angegebenen Anzahl von
+	 * Kommandos an (nur als Rahmen #FRAME_ACK).
+	 */
+	void ack (uint32_t count);
+
+	/**
+	 * Liest eine vorzeichenlose Zahl mit der angegebenen Anzahl von
+	 * Bytes (little-endian) aus einem Rahmen.
+	 */
+	static uint32_t getUint (const unsigned char* data, int bytes);
+};
+
+#endif /* COMMANDENCODER_H_ */
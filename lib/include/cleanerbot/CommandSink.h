@@ -0,0 +1,29 @@
+/*
+ * @file CommandSink.h
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#ifndef COMMANDSINK_H_
+#define COMMANDSINK_H_
+
+#include <string>
+
+/**
+ * Diese Klasse ist die Schnittstelle fr Empfnger der Kommandos, die
+ * eine World ohne Verbindung zum Anzeige-Server (s. World#HEADLESS)
+ * erzeugt. Ein Empfnger kann die Kommandos z.&nbsp;B. aufzeichnen,
+ * um einen Simulationslauf spter anzuzeigen oder zu prfen.
+ */
+class CommandSink {
+public:
+	CommandSink();
+	virtual ~CommandSink();
+
+	/**
+	 * Nimmt ein Kommando (ohne Zeilenende) entgegen.
+	 */
+	virtual void command (const std::string& cmd) = 0;
+};
+
+#endif /* COMMANDSINK_H_ */
@@ -0,0 +1,173 @@
+/*
+ * @file DisplayServer.h
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#ifndef DISPLAYSERVER_H_
+#define DISPLAYSERVER_H_
+
+#ifdef __linux__
+
+#include <string>
+#include <vector>
+#include <map>
+#include <ostream>
+#include <chrono>
+#include "cleanerbot/CommandEncoder.h"
+#include "../util/SocketReactor.h"
+
+/**
+ * Diese Klasse ist ein einfacher Ersatz fr den Anzeige-Server. Sie
+ * beantwortet alle Kommandos, die World sendet (<code>SET NAME</code>,
+ * <code>START SCENE</code>, <code>WALL</code>, <code>END SCENE</code>,
+ * <code>VACUUM CLEANER</code>, <code>STATUSLINE</code>,
+ * <code>GET KEY</code> einschlielich der vorlufigen Antwort 1xx und
+ * <code>CLOSE</code>) im Text- und im binren Protokoll
+ * (s. CommandChannel), zeigt aber nichts an. Damit kann die bertragung
+ * ohne die graphische Konsole gemessen und geprft werden.
+ *
+ * Alle Verbindungen werden von einem Thread mit einem SocketReactor
+ * bearbeitet. Mit #setLatency kann eine Verzgerung der Antworten
+ * eingestellt werden, die (wie die Laufzeit im Netz) den Durchsatz nicht
+ * begrenzt. Fr jede Art von Kommando werden die Anzahl, der Durchsatz
+ * und ein Histogramm der Zeit zwischen Empfang des Kommandos und Senden
+ * der Antwort erfasst (s. #report).
+ *
+ * Die Klasse steht nur unter Linux zur Verfgung.
+ */
+class DisplayServer : private ReactorHandler {
+public:
+	/**
+	 * Die Arten von Kommandos, fr die Statistiken gefhrt werden.
+	 */
+	enum CommandType {
+		SET_NAME, START_SCENE, WALL, END_SCENE, VACUUM_CLEANER,
+		STATUSLINE, GET_KEY, CLOSE, PROTOCOL, UNKNOWN,
+		/** Die Anzahl der Arten. */
+		COMMAND_TYPES
+	};
+
+	/**
+	 * Die Anzahl der Klassen des Histogramms. Klasse i enthlt die
+	 * Antwortzeiten unter 2<sup>i</sup> Mikrosekunden, die letzte
+	 * Klasse alle lngeren.
+	 */
+	static const int HISTOGRAM_BUCKETS = 24;
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	struct Statistics {
+		unsigned long count;
+		Clock::time_point first;
+		Clock::time_point last;
+		unsigned long histogram[HISTOGRAM_BUCKETS];
+	};
+
+	// Replies to the commands received in one read
+	struct Reply {
+		std::string data;
+		Clock::time_point received;
+		unsigned counts[COMMAND_TYPES];
+		bool close;
+	};
+
+	struct Client {
+		bool binary;
+		std::string name;
+		// Successful commands not yet acknowledged (binary protocol)
+		uint32_t unacknowledged;
+		// Replies waiting for the configured latency
+		unsigned delayed;
+		// The client has finished sending
+		bool ended;
+	};
+
+	SocketServer server;
+	SocketReactor reactor;
+	Clock::duration latency;
+	bool binarySupported;
+	std::vector<std::string> keys;
+	size_t nextKey;
+	std::map<int, Client> clients;
+	Statistics statistics[COMMAND_TYPES];
+	unsigned long wallVertices;
+	unsigned long bytesReceived;
+	unsigned long connections;
+	bool stopped;
+
+	virtual void OnConnect (ReactorConnection& con);
+	virtual void OnData (ReactorConnection& con);
+	virtual void OnEnd (ReactorConnection& con);
+	virtual void OnClose (ReactorConnection& con);
+	bool handleLine (Client& client, const std::string& line, Reply& reply);
+	bool handleFrame (Client& client, uint8_t type, const std::string& payload,
+					  Reply& reply);
+	void answer (Client& client, Reply& reply, CommandType type, int code,
+				 const std::string& rest);
+	void flushAcks (Client& client, Reply& reply);
+	void send (int id, Reply& reply);
+	void sendDelayed (int id, Reply& reply);
+	void record (const Reply& reply);
+
+public:
+	/**
+	 * Erzeugt einen Server, der auf dem angegebenen Port Verbindungen
+	 * annimmt.
+	 */
+	DisplayServer(int port = 23454);
+	virtual ~DisplayServer();
+
+	/**
+	 * Setzt die Verzgerung, mit der die Antworten gesendet werden.
+	 *
+	 * @param seconds die Verzgerung in Sekunden.
+	 */
+	void setLatency (double seconds);
+
+	/**
+	 * Legt fest, ob das binre Protokoll angeboten wird. Ohne binres
+	 * Protokoll verhlt sich der Server wie die ursprngliche Konsole
+	 * und lehnt <code>PROTOCOL BINARY</code> ab.
+	 */
+	void setBinarySupported (bool supported);
+
+	/**
+	 * Legt die Tasten fest, die nacheinander (und danach wieder von
+	 * vorne) als Antwort auf <code>GET KEY</code> geliefert werden.
+	 */
+	void setKeys (const std::vector<std::string>& keys);
+
+	/**
+	 * Bearbeitet die Verbindungen fr die angegebene Zeit (0: bis
+	 * #stop aufgerufen wird).
+	 */
+	void run (double seconds = 0);
+
+	/**
+	 * Wartet hchstens die angegebene Zeit auf Kommandos und bearbeitet
+	 * sie.
+	 */
+	void runOnce (int timeoutMs);
+
+	/**
+	 * Beendet #run.
+	 */
+	void stop ();
+
+	/**
+	 * Liefert die Anzahl der bisher empfangenen Kommandos der
+	 * angegebenen Art.
+	 */
+	unsigned long getCount (CommandType type) const;
+
+	/**
+	 * Gibt die Statistiken aller Arten von Kommandos aus.
+	 */
+	void report (std::ostream& out) const;
+};
+
+#endif
+
+#endif /* DISPLAYSERVER_H_ */
@@ -9,12 +9,52 @@
 #ifndef GEOMETRY_H_
 #define GEOMETRY_H_
 
+#include <type_traits>
 #include "geometrylib/GeometryLib.h"
 
-typedef GeometryLib::Point2D<double> Point2D;
-typedef GeometryLib::Vector2D<double> Vector2D;
-typedef GeometryLib::Segment2D<double> Segment2D;
-typedef GeometryLib::Polygon2D<double> Polygon2D;
-typedef GeometryLib::Ray2D<double> Ray2D;
+/**
+ * Der Datentyp fr Koordinaten und Entfernungen. Wird beim bersetzen
+ * CLEANERBOT_FLOAT definiert, so wird mit einfacher Genauigkeit
+ * gerechnet. Das halbiert den Speicherbedarf der Kanten und
+ * verdoppelt die Anzahl der gleichzeitig geprften Kanten
+ * (s. RayKernel). Fr Rume mit Abmessungen von einigen Metern ist
+ * die Genauigkeit ausreichend.
+ *
+ * Wird CLEANERBOT_FIXED definiert, so wird mit Festkommazahlen
+ * (GeometryLib::Fixed, Q16.16) gerechnet. Die Entfernungsberechnung
+ * kommt dann ohne Gleitkommarechnung aus, was auf Prozessoren ohne
+ * Gleitkommaeinheit erheblich schneller ist. Die Auflsung betrgt
+ * etwa 15 Mikrometer, alle Koordinaten mssen betragsmig kleiner
+ * als 8192 m sein.
+ */
+#if defined(CLEANERBOT_FIXED)
+typedef GeometryLib::Fixed Scalar;
+#elif defined(CLEANERBOT_FLOAT)
+typedef float Scalar;
+#else
+typedef double Scalar;
+#endif
+
+typedef GeometryLib::Point2D<Scalar> Point2D;
+typedef GeometryLib::Vector2D<Scalar> Vector2D;
+typedef GeometryLib::Segment2D<Scalar> Segment2D;
+typedef GeometryLib::Polygon2D<Scalar> Polygon2D;
+typedef GeometryLib::Ray2D<Scalar> Ray2D;
+
+// The domain classes rely on these being plain values that can be
+// stored densely and copied as raw memory.
+static_assert(std::is_trivially_copyable<Point2D>::value
+			  && std::is_standard_layout<Point2D>::value
+			  && sizeof(Point2D) == 2 * sizeof(Scalar),
+			  "Point2D must be a plain value");
+static_assert(std::is_trivially_copyable<Vector2D>::value
+			  && std::is_standard_layout<Vector2D>::value,
+			  "Vector2D must be a plain value");
+static_assert(std::is_trivially_copyable<Segment2D>::value
+			  && std::is_standard_layout<Segment2D>::value,
+			  "Segment2D must be a plain value");
+static_assert(std::is_trivially_copyable<Ray2D>::value
+			  && std::is_standard_layout<Ray2D>::value,
+			  "Ray2D must be a plain value");
 
 #endif /* GEOMETRY_H_ */
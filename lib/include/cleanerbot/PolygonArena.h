@@ -0,0 +1,144 @@
+/*
+ * @file PolygonArena.h
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#ifndef POLYGONARENA_H_
+#define POLYGONARENA_H_
+
+#include <vector>
+#include "cleanerbot/Geometry.h"
+
+/**
+ * Diese Klasse ist eine nicht besitzende Referenz auf ein Polygon, dessen
+ * Ecken zusammenhngend im Speicher liegen, z.&nbsp;B. in einer
+ * PolygonArena oder in einem Polygon2D. Die Referenz ist gltig, solange
+ * der Speicher der Ecken nicht verndert oder freigegeben wird.
+ */
+class PolygonRef {
+private:
+	const Point2D* points;
+	size_t count;
+
+public:
+	/**
+	 * Eine Sicht auf die Ecken des Polygons.
+	 */
+	typedef GeometryLib::Range<const Point2D*> VertexRange;
+
+	/**
+	 * Erzeugt eine Referenz auf das Polygon mit den <code>count</code>
+	 * Ecken ab <code>points</code>.
+	 */
+	PolygonRef(const Point2D* points, size_t count);
+
+	/**
+	 * Erzeugt eine Referenz auf die Ecken des bergebenen Polygons.
+	 */
+	PolygonRef(const Polygon2D& polygon);
+
+	/**
+	 * Liefert die Ecken des Polygons.
+	 */
+	VertexRange vertices () const;
+
+	/**
+	 * Liefert die Anzahl der Kanten des Polygons (s. Polygon2D#edgeCount).
+	 */
+	size_t edgeCount () const;
+
+	/**
+	 * Liefert die Kanten des Polygons (s. Polygon2D#edgeRange).
+	 */
+	Polygon2D::EdgeRange edgeRange () const;
+
+	/**
+	 * Liefert eine Kopie des Polygons.
+	 */
+	Polygon2D toPolygon () const;
+};
+
+/**
+ * Diese Klasse speichert die Ecken beliebig vieler Polygone
+ * zusammenhngend in einem Block. Ein zweiter Block enthlt fr jedes
+ * Polygon den Index seiner ersten Ecke. Die Polygone werden ber ihren
+ * Index angesprochen und als PolygonRef geliefert.
+ *
+ * Unabhngig von der Anzahl der Polygone belegt eine PolygonArena damit
+ * nur zwei Speicherblcke, die beim Kopieren am Stck kopiert und beim
+ * Zerstren am Stck freigegeben werden. Mit #clear kann die Arena unter
+ * Beibehaltung des Speichers wiederverwendet werden.
+ */
+class PolygonArena {
+private:
+	std::vector<Point2D> points;
+	// Index of the first vertex of each polygon, plus one final entry
+	std::vector<size_t> starts;
+
+public:
+	/**
+	 * Iterator ber die Polygone der Arena.
+	 */
+	typedef GeometryLib::IndexIterator<PolygonArena, PolygonRef> Iterator;
+
+	/**
+	 * Eine Sicht auf einen Teil der Polygone der Arena.
+	 */
+	typedef GeometryLib::Range<Iterator> Range;
+
+	/**
+	 * Erzeugt eine leere Arena.
+	 */
+	PolygonArena();
+	virtual ~PolygonArena();
+
+	/**
+	 * Fgt eine Kopie des bergebenen Polygons hinzu und liefert dessen
+	 * Index. Alle vorher gelieferten Referenzen werden dabei ungltig.
+	 * Das Polygon darf auch aus dieser Arena stammen
+	 * (<code>arena.add(arena[i])</code>).
+	 */
+	size_t add (const PolygonRef& polygon);
+
+	/**
+	 * Liefert die Anzahl der Polygone.
+	 */
+	size_t size () const;
+
+	/**
+	 * Liefert die Gesamtzahl der Ecken aller Polygone.
+	 */
+	size_t vertexCount () const;
+
+	/**
+	 * Liefert eine Referenz auf das Polygon mit dem angegebenen Index.
+	 */
+	PolygonRef operator[] (size_t index) const;
+
+	/**
+	 * Liefert eine Sicht auf alle Polygone.
+	 */
+	Range range () const;
+
+	/**
+	 * Liefert eine Sicht auf die Polygone mit den Indizes von
+	 * <code>first</code> (einschlielich) bis <code>last</code>
+	 * (ausschlielich).
+	 */
+	Range range (size_t first, size_t last) const;
+
+	/**
+	 * Reserviert Speicher fr die angegebene Anzahl von Polygonen
+	 * und Ecken.
+	 */
+	void reserve (size_t polygons, size_t vertices);
+
+	/**
+	 * Entfernt alle Polygone. Der belegte Speicher bleibt fr
+	 * die Wiederverwendung erhalten.
+	 */
+	void clear ();
+};
+
+#endif /* POLYGONARENA_H_ */
@@ -0,0 +1,76 @@
+/*
+ * @file PolygonUnion.h
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#ifndef POLYGONUNION_H_
+#define POLYGONUNION_H_
+
+#include <vector>
+#include "cleanerbot/Geometry.h"
+#include "cleanerbot/PolygonArena.h"
+#include "cleanerbot/SegmentScene.h"
+
+/**
+ * Diese Klasse bestimmt den Rand der Vereinigung mehrerer Polygone.
+ * Sie wird von Wall#bake verwendet, um die Kanten der (sich
+ * berlappenden) Polygone einer Wand auf die Kanten zu reduzieren, die
+ * bei der Entfernungsberechnung tatschlich getroffen werden knnen.
+ *
+ * Dazu werden die Kanten an allen Schnittpunkten mit Kanten der anderen
+ * Polygone geteilt. Teilstcke, die im Inneren eines anderen Polygons
+ * liegen oder an denen sich zwei Polygone von verschiedenen Seiten
+ * berhren, entfallen, ebenso Kanten der Lnge null. Mehrfach vorhandene
+ * Teilstcke werden nur einmal bernommen. Abschlieend werden
+ * aufeinander folgende Teilstcke, die auf einer Geraden liegen, zu
+ * einer Kante zusammengefasst.
+ *
+ * Alle Entscheidungen beruhen auf exakten Orientierungstests
+ * (s. GeometryLib#orientation). Polygone mit weniger als drei Ecken
+ * oder ohne Flche tragen nur ihre Kanten bei. Die Polygone drfen sich
+ * nicht selbst schneiden. Der Aufwand ist quadratisch in der Anzahl der
+ * Kanten.
+ */
+class PolygonUnion {
+private:
+	struct Edge {
+		Point2D start;
+		Point2D end;
+		int polygon;
+	};
+
+	std::vector<Edge> edges;
+	// Index of the first edge of each polygon, plus one final entry
+	std::vector<size_t> polygonStart;
+	// Whether the polygon encloses an area
+	std::vector<bool> closed;
+
+	void split (std::vector<Edge>& pieces) const;
+	bool inside (const Point2D& point, int polygon) const;
+
+public:
+	/**
+	 * Erzeugt eine leere Vereinigung.
+	 */
+	PolygonUnion();
+	virtual ~PolygonUnion();
+
+	/**
+	 * Fgt das bergebene Polygon zur Vereinigung hinzu.
+	 */
+	void add (const PolygonRef& polygon);
+
+	/**
+	 * Liefert die Anzahl der Kanten aller hinzugefgten Polygone.
+	 */
+	size_t size () const;
+
+	/**
+	 * Fgt die Kanten des Rands der Vereinigung zu der bergebenen
+	 * Szene hinzu.
+	 */
+	void outline (SegmentScene& scene) const;
+};
+
+#endif /* POLYGONUNION_H_ */
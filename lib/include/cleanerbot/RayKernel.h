@@ -0,0 +1,82 @@
+/*
+ * @file RayKernel.h
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#ifndef RAYKERNEL_H_
+#define RAYKERNEL_H_
+
+#include <cstddef>
+#include "geometrylib/Fixed.h"
+
+/**
+ * Diese Klasse stellt die innerste Schleife der Entfernungsberechnung
+ * bereit: den Schnitt eines Strahls mit vielen Strecken, die als
+ * getrennte Felder fr Anfangspunkt und Richtungsvektor vorliegen
+ * (s. SegmentScene).
+ *
+ * Beim ersten Aufruf wird anhand der Fhigkeiten des Prozessors eine
+ * Implementierung ausgewhlt. Auf x86-Prozessoren mit AVX2 werden vier
+ * Strecken pro Befehl geprft, mit SSE2 zwei. Mit einfacher Genauigkeit
+ * (<code>float</code>) verdoppelt sich die Anzahl. Auf allen anderen
+ * Prozessoren wird eine skalare Implementierung verwendet. Alle
+ * Implementierungen liefern dieselben Ergebnisse. Fr Festkommazahlen
+ * (GeometryLib::Fixed) gibt es eine Implementierung, die nur mit
+ * ganzen Zahlen rechnet.
+ *
+ * Ob ein Schnittpunkt vorliegt, hngt nur von den Vorzeichen von vier
+ * Kreuzprodukten ab. Fr jedes wird aus den Betrgen seiner Summanden
+ * eine obere Schranke fr den Rundungsfehler bestimmt. Ist der Betrag
+ * eines Kreuzprodukts nicht grer als diese Schranke (z. B. bei
+ * Strahlen durch Ecken, nahe dem Anfangspunkt oder nahezu parallel zur
+ * Strecke), wird exakt gerechnet (s. GeometryLib::Expansion). Die
+ * Entscheidung ist daher (sofern kein Unterlauf auftritt) immer exakt,
+ * nur die Entfernung selbst ist gerundet.
+ */
+class RayKernel {
+public:
+	/**
+	 * Berechnet die Entfernung vom Punkt (ox; oy) in Richtung des
+	 * Einheitsvektors (rx; ry) bis zum ersten Schnittpunkt mit einer
+	 * der <code>n</code> Strecken
+	 * (x0[i]; y0[i]) + u * (dx[i]; dy[i]) mit 0 &lt;= u &lt;= 1.
+	 * Es werden nur Schnittpunkte bercksichtigt, die nher als
+	 * <code>maxDist</code> liegen. Gibt es keinen solchen Schnittpunkt,
+	 * so wird <code>maxDist</code> zurckgeliefert.
+	 */
+	static double distance (double ox, double oy, double rx, double ry,
+			const double* x0, const double* y0,
+			const double* dx, const double* dy,
+			size_t n, double maxDist);
+
+	/**
+	 * Berechnet die Entfernung wie oben mit einfacher Genauigkeit.
+	 */
+	static float distance (float ox, float oy, float rx, float ry,
+			const float* x0, const float* y0,
+			const float* dx, const float* dy,
+			size_t n, float maxDist);
+
+	/**
+	 * Berechnet die Entfernung wie oben mit Festkommazahlen. Die
+	 * Berechnung erfolgt ausschlielich mit ganzen Zahlen und ist
+	 * exakt bis auf das Abrunden der Entfernung auf die Auflsung
+	 * von GeometryLib::Fixed. Alle Koordinaten mssen betragsmig
+	 * kleiner als 8192 sein.
+	 */
+	static GeometryLib::Fixed distance (GeometryLib::Fixed ox,
+			GeometryLib::Fixed oy, GeometryLib::Fixed rx,
+			GeometryLib::Fixed ry, const GeometryLib::Fixed* x0,
+			const GeometryLib::Fixed* y0, const GeometryLib::Fixed* dx,
+			const GeometryLib::Fixed* dy, size_t n,
+			GeometryLib::Fixed maxDist);
+
+	/**
+	 * Liefert den Namen der ausgewhlten Implementierung
+	 * ("avx2", "sse2" oder "scalar").
+	 */
+	static const char* implementation ();
+};
+
+#endif /* RAYKERNEL_H_ */
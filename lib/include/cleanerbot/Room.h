@@ -10,8 +10,14 @@
 #define ROOM_H_
 
 #include <list>
+#include <vector>
 #include "cleanerbot/Boundary.h"
+#include "cleanerbot/PolygonArena.h"
 #include "cleanerbot/Wall.h"
+#include "cleanerbot/SegmentScene.h"
+#include "cleanerbot/SegmentBVH.h"
+#include "cleanerbot/SegmentGrid.h"
+#include "cleanerbot/ClearanceField.h"
 
 /**
  * Diese Klasse reprsentiert einen Raum, in dem sich der Saugroboter bewegen
@@ -19,10 +25,85 @@
  * sind fr den Raum keine Wnde definiert (unendlich groer Raum). Die Wnde
  * mssen durch Aufrufe der Methode #addWall zum Raum hinzugefgt werden.
  * Damit ist es mglich, Rume mit beliebigen Formen zu definieren.
+ *
+ * Der Raum speichert keine Objekte vom Typ Wall. Die Ecken der Polygone
+ * aller Wnde liegen zusammenhngend in einer PolygonArena, zu jeder
+ * Wand wird nur der Index ihres ersten Polygons gespeichert. Die Kanten
+ * liegen in einer gemeinsamen SegmentScene. Ein Raum belegt daher
+ * unabhngig von der Anzahl der Wnde nur wenige Speicherblcke, die
+ * beim Kopieren und Zerstren am Stck kopiert bzw. freigegeben werden.
+ * Wnde werden ber WallRef angesprochen.
  */
 class Room: public Boundary {
+public:
+	/**
+	 * Die Suchstrukturen, die #bake fr die Berechnung der Entfernungen
+	 * aufbauen kann.
+	 */
+	enum Accelerator {
+		/** Keine Suchstruktur, alle Kanten werden geprft. */
+		LINEAR_SCAN,
+		/** Hierarchie umschlieender Rechtecke (SegmentBVH). */
+		BOUNDING_VOLUMES,
+		/** Gleichmiges Gitter (SegmentGrid). */
+		UNIFORM_GRID
+	};
+
+	/**
+	 * Eine Referenz auf eine Wand des Raums ber ihren Index. Die
+	 * Referenz ist gltig, solange der Raum existiert, die gelieferten
+	 * Polygone, bis der Raum verndert wird.
+	 */
+	class WallRef {
+	private:
+		const Room* room;
+		size_t index;
+
+	public:
+		/**
+		 * Erzeugt eine Referenz auf die Wand mit dem angegebenen Index.
+		 */
+		WallRef(const Room* room, size_t index);
+
+		/**
+		 * Liefert den Index der Wand im Raum.
+		 */
+		size_t getIndex () const;
+
+		/**
+		 * Liefert die Polygone, die zusammen die Grundflche der
+		 * Wand bilden (s. Wall#shapeRange).
+		 */
+		Wall::ShapeRange shapeRange () const;
+
+		/**
+		 * Liefert eine Kopie der Wand.
+		 */
+		Wall toWall () const;
+	};
+
+	/**
+	 * Iterator ber die Wnde des Raums.
+	 */
+	typedef GeometryLib::IndexIterator<Room, WallRef> WallIterator;
+
+	/**
+	 * Eine Sicht auf die Wnde des Raums (s. #wallRange).
+	 */
+	typedef GeometryLib::Range<WallIterator> WallRange;
+
 private:
-	std::list<Wall> walls;
+	PolygonArena shapes;
+	// Index of the first polygon of each wall, plus one final entry
+	std::vector<size_t> wallStart;
+	SegmentScene segments;
+	bool outlined;
+	Accelerator accelerator;
+	SegmentBVH bvh;
+	SegmentGrid grid;
+	bool baked;
+	size_t shapeEdges;
+	ClearanceField clearanceField;
 
 public:
 	/**
@@ -32,22 +113,146 @@ public:
 	virtual ~Room();
 
 	/**
-	 * Liefert eine Liste mit allen Wnden, die zu dem Raum mit
+	 * Liefert eine Liste mit Kopien aller Wnde, die zu dem Raum mit
 	 * #addWall hinzugefgt wurden.
 	 */
 	std::list<Wall> getWalls() const;
 
+	/**
+	 * Liefert alle Wnde, die zu dem Raum mit #addWall hinzugefgt
+	 * wurden, ohne sie zu kopieren. Die Sicht ist gltig, bis der Raum
+	 * verndert oder zerstrt wird.
+	 */
+	WallRange wallRange() const;
+
+	/**
+	 * Liefert die Anzahl der Wnde.
+	 */
+	size_t wallCount () const;
+
+	/**
+	 * Liefert eine Referenz auf die Wand mit dem angegebenen Index.
+	 */
+	WallRef operator[] (size_t index) const;
+
 	/**
 	 * Fgt eine Kopie des bergebenen Objekts von Typ Wall zu dem Raum
-	 * hinzu.
+	 * hinzu. Ein mit #buildClearance aufgebautes Abstandsfeld wird
+	 * dabei aktualisiert.
 	 */
 	void addWall (const Wall& wall);
 
+	/**
+	 * Entfernt alle Wnde aus dem Raum, ein Abstandsfeld und die
+	 * Suchstruktur. Der von den Wnden belegte Speicher wird nicht
+	 * freigegeben, sondern beim erneuten Aufbau des Raums wiederverwendet.
+	 */
+	void clear ();
+
+	/**
+	 * Liefert die Suchstruktur, die #bake aufbaut.
+	 */
+	Accelerator getAccelerator() const;
+
+	/**
+	 * Legt die Suchstruktur fest, die #bake aufbaut. Vorgabe ist
+	 * #BOUNDING_VOLUMES. Eine bereits aufgebaute Suchstruktur wird
+	 * verworfen, #bake muss danach erneut aufgerufen werden.
+	 */
+	void setAccelerator(Accelerator accelerator);
+
+	/**
+	 * Bereitet den Raum fr schnelle Entfernungsberechnungen vor. Dazu
+	 * werden zunchst die Kanten jeder Wand auf den Rand der Vereinigung
+	 * ihrer Polygone reduziert (s. Wall#bake, das Ergebnis bleibt bis
+	 * zum nchsten Aufruf von #addWall erhalten). Anschlieend wird ber
+	 * die verbleibenden Kanten aller Wnde die mit #setAccelerator
+	 * festgelegte Suchstruktur aufgebaut. Wie stark sich die Anzahl der
+	 * Kanten dadurch verringert, liefern #getShapeEdgeCount und
+	 * #getEdgeCount. Bis zum nchsten Aufruf von
+	 * #addWall verwendet #distance diese Suchstruktur, danach muss die
+	 * Methode erneut aufgerufen werden. World#setRoom ruft die Methode
+	 * fr den bernommenen Raum auf.
+	 */
+	void bake ();
+
+	/**
+	 * Liefert die Anzahl der Kanten aller Polygone aller Wnde, wie sie
+	 * beim letzten Aufruf von #bake vorlagen.
+	 */
+	size_t getShapeEdgeCount () const;
+
+	/**
+	 * Liefert die Anzahl der Kanten, die bei der Entfernungsberechnung
+	 * geprft werden. Nach #bake ist das die Anzahl der Kanten, die nach
+	 * dem Entfernen innen liegender, doppelter und entarteter Kanten und
+	 * dem Zusammenfassen von Kanten auf einer Geraden verbleiben.
+	 */
+	size_t getEdgeCount () const;
+
 	/**
 	 * Berechnet die Entfernung vom Anfangspunkt des bergebenen Strahls
 	 * bis zum ersten Schnittpunkt mit einer Mauer des Raums.
+	 *
+	 * Die Kanten aller Wnde werden beim Hinzufgen mit #addWall
+	 * in einer gemeinsamen SegmentScene abgelegt. Die Berechnung
+	 * durchluft daher nur diese Felder und kommt ohne
+	 * Speicheranforderungen aus. Nach einem Aufruf von #bake werden
+	 * nur noch die Kanten in der Nhe des Strahls geprft.
+	 */
+	virtual Scalar distance (const Ray2D& ray) const;
+
+	/**
+	 * Bestimmt die Entfernungen fr einen Fcher von Strahlen
+	 * (s. Boundary#scan) mit der durch #bake aufgebauten Suchstruktur.
+	 * Die Ergebnisse werden ohne Speicheranforderungen in das vom
+	 * Aufrufer bereitgestellte Feld geschrieben.
+	 */
+	virtual void scan (const Point2D& origin, Scalar firstAngle,
+			           Scalar angleStep, size_t count,
+			           Scalar distances[]) const;
+
+	/**
+	 * Berechnet die Strecke, die der Saugroboter (ein Kreis mit dem
+	 * Radius <code>radius</code>) vom Anfangspunkt des Strahls aus in
+	 * dessen Richtung zurcklegen kann, bis er eine Wand berhrt
+	 * (Zeitpunkt der ersten Berhrung einer kontinuierlichen Bewegung).
+	 * Es werden nur Berhrungen bercksichtigt, die nher als
+	 * <code>maxDist</code> liegen. Gibt es keine, wird
+	 * <code>maxDist</code> zurckgeliefert. Anderenfalls wird
+	 * <code>normal</code> auf den Einheitsvektor gesetzt, der im
+	 * Berhrpunkt von der Wand weg zeigt. Damit kann eine Bewegung
+	 * begrenzt, entlang der Wand fortgesetzt oder abgelehnt werden.
+	 *
+	 * Die Berechnung verwendet die durch #bake aufgebaute Suchstruktur
+	 * (s. SegmentScene#sweep).
+	 */
+	Scalar sweep (const Ray2D& path, Scalar radius, Scalar maxDist,
+			      Vector2D& normal) const;
+
+	/**
+	 * Baut ein Abstandsfeld (s. ClearanceField) mit der angegebenen
+	 * Auflsung fr die Wnde des Raums auf. Danach beantworten
+	 * #clearance und #clearanceGradient Anfragen mit konstantem Aufwand.
+	 * Spter mit #addWall hinzugefgte Wnde werden in das Feld
+	 * eingearbeitet.
+	 */
+	void buildClearance (Scalar resolution = 0.05);
+
+	/**
+	 * Liefert den Abstand der bergebenen Position von der nchsten
+	 * Wand. Ist ein Abstandsfeld aufgebaut, wird der Wert daraus
+	 * interpoliert und ist innerhalb von Wnden negativ. Anderenfalls
+	 * wird der Abstand zu allen Kanten berechnet.
+	 */
+	Scalar clearance (const Point2D& position) const;
+
+	/**
+	 * Liefert den Gradienten des Abstands von der nchsten Wand an der
+	 * bergebenen Position (s. ClearanceField#gradient). Ist kein
+	 * Abstandsfeld aufgebaut, wird der Nullvektor zurckgeliefert.
 	 */
-	virtual double distance (const Ray2D& ray) const;
+	Vector2D clearanceGradient (const Point2D& position) const;
 };
 
 #endif /* ROOM_H_ */
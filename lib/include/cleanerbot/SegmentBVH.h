@@ -0,0 +1,91 @@
+/*
+ * @file SegmentBVH.h
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#ifndef SEGMENTBVH_H_
+#define SEGMENTBVH_H_
+
+#include <vector>
+#include "cleanerbot/Boundary.h"
+#include "cleanerbot/SegmentScene.h"
+
+/**
+ * Diese Klasse ist eine Suchstruktur (Bounding Volume Hierarchy) ber
+ * die Kanten einer SegmentScene. Die Hierarchie wird mit Hilfe der
+ * "Surface Area Heuristic" aufgebaut und als zusammenhngendes Feld von
+ * Knoten abgelegt. Die Kanten werden dabei so umsortiert, dass die Kanten
+ * eines Blattes im Speicher direkt aufeinander folgen.
+ *
+ * Bei der Berechnung der Entfernung werden nur die Knoten besucht, deren
+ * umschlieendes Rechteck vom Strahl nher als der bisher nchste
+ * Schnittpunkt getroffen wird. Der Aufwand wchst daher nur logarithmisch
+ * mit der Anzahl der Kanten.
+ */
+class SegmentBVH: public Boundary {
+private:
+	struct Node {
+		Scalar minX, minY, maxX, maxY;
+		// Index of the first edge (leaf) or of the left child (inner node,
+		// the right child follows directly)
+		unsigned int first;
+		// Number of edges (leaf) or 0 (inner node)
+		unsigned int count;
+	};
+	std::vector<Node> nodes;
+	SegmentScene segments;
+
+	void subdivide (unsigned int nodeIdx, std::vector<unsigned int>& order,
+			        const std::vector<Scalar>& cx,
+			        const std::vector<Scalar>& cy,
+			        const SegmentScene& scene);
+	void updateBounds (Node& node, const std::vector<unsigned int>& order,
+			           const SegmentScene& scene) const;
+	Scalar traverse (Scalar ox, Scalar oy, Scalar rx, Scalar ry,
+			         Scalar radius, Scalar maxDist, Vector2D* normal) const;
+
+public:
+	/**
+	 * Erzeugt eine leere Suchstruktur.
+	 */
+	SegmentBVH();
+	virtual ~SegmentBVH();
+
+	/**
+	 * Baut die Suchstruktur fr die Kanten der bergebenen Szene auf.
+	 * Eine eventuell vorher aufgebaute Struktur wird dabei verworfen.
+	 */
+	void build (const SegmentScene& scene);
+
+	/**
+	 * Liefert die Anzahl der Kanten in der Suchstruktur.
+	 */
+	size_t size () const;
+
+	/**
+	 * Berechnet die Entfernung vom Anfangspunkt des bergebenen Strahls
+	 * bis zum ersten Schnittpunkt mit einer Kante der Suchstruktur.
+	 */
+	virtual Scalar distance (const Ray2D& ray) const;
+
+	/**
+	 * Bestimmt die Entfernungen fr einen Fcher von Strahlen
+	 * (s. Boundary#scan).
+	 */
+	virtual void scan (const Point2D& origin, Scalar firstAngle,
+			           Scalar angleStep, size_t count,
+			           Scalar distances[]) const;
+
+	/**
+	 * Berechnet die Strecke, die ein Kreis entlang des Strahls
+	 * zurcklegen kann, bis er eine Kante berhrt
+	 * (s. SegmentScene#sweep). Dabei werden nur die Knoten besucht,
+	 * deren um den Radius vergrertes Rechteck der Strahl nher als
+	 * die bisher nchste Berhrung trifft.
+	 */
+	Scalar sweep (const Ray2D& path, Scalar radius, Scalar maxDist,
+			      Vector2D& normal) const;
+};
+
+#endif /* SEGMENTBVH_H_ */
@@ -0,0 +1,86 @@
+/*
+ * @file SegmentGrid.h
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#ifndef SEGMENTGRID_H_
+#define SEGMENTGRID_H_
+
+#include <vector>
+#include "cleanerbot/Boundary.h"
+#include "cleanerbot/SegmentScene.h"
+
+/**
+ * Diese Klasse ist eine Suchstruktur ber die Kanten einer SegmentScene,
+ * die die Ebene in ein gleichmiges Gitter von Zellen einteilt. Jede
+ * Zelle kennt die Kanten, die sie berhren. Die Kanten einer Zelle liegen
+ * im Speicher direkt hintereinander (Kanten, die mehrere Zellen berhren,
+ * werden dazu mehrfach abgelegt).
+ *
+ * Bei der Berechnung der Entfernung werden die vom Strahl getroffenen
+ * Zellen in der Reihenfolge ihres Abstands vom Anfangspunkt des Strahls
+ * besucht (2D-DDA nach Amanatides und Woo). Die Suche endet in der ersten
+ * Zelle, in der ein Schnittpunkt gefunden wird. Insbesondere fr kurze
+ * Strahlen in dicht bebauten, berwiegend rechtwinkligen Rumen ist das
+ * schneller als eine hierarchische Suchstruktur.
+ */
+class SegmentGrid: public Boundary {
+private:
+	Scalar minX, minY;
+	Scalar cellWidth, cellHeight;
+	int columns, rows;
+	// Index of the first edge of each cell, plus one final entry
+	std::vector<unsigned int> cellStart;
+	SegmentScene segments;
+
+	Scalar distance (Scalar ox, Scalar oy, Scalar rx, Scalar ry) const;
+
+public:
+	/**
+	 * Erzeugt eine leere Suchstruktur.
+	 */
+	SegmentGrid();
+	virtual ~SegmentGrid();
+
+	/**
+	 * Baut die Suchstruktur fr die Kanten der bergebenen Szene auf.
+	 * Eine eventuell vorher aufgebaute Struktur wird dabei verworfen.
+	 * Die Gre der Zellen wird so gewhlt, dass auf eine Zelle im Mittel
+	 * etwa eine halbe Kante kommt.
+	 */
+	void build (const SegmentScene& scene);
+
+	/**
+	 * Liefert die Anzahl der Zellen des Gitters.
+	 */
+	size_t cells () const;
+
+	/**
+	 * Berechnet die Entfernung vom Anfangspunkt des bergebenen Strahls
+	 * bis zum ersten Schnittpunkt mit einer Kante der Suchstruktur.
+	 */
+	virtual Scalar distance (const Ray2D& ray) const;
+
+	/**
+	 * Bestimmt die Entfernungen fr einen Fcher von Strahlen
+	 * (s. Boundary#scan).
+	 */
+	virtual void scan (const Point2D& origin, Scalar firstAngle,
+			           Scalar angleStep, size_t count,
+			           Scalar distances[]) const;
+
+	/**
+	 * Berechnet die Strecke, die ein Kreis entlang des Strahls
+	 * zurcklegen kann, bis er eine Kante berhrt
+	 * (s. SegmentScene#sweep). Die Zellen werden wie bei der Entfernung
+	 * entlang der Bewegung des Mittelpunkts besucht, dabei werden jeweils
+	 * die Zellen im Abstand des Radius mit geprft. Die Suche endet, wenn
+	 * eine Berhrung gefunden wurde, bevor der Mittelpunkt die aktuelle
+	 * Zelle verlsst.
+	 */
+	Scalar sweep (const Ray2D& path, Scalar radius, Scalar maxDist,
+			      Vector2D& normal) const;
+};
+
+#endif /* SEGMENTGRID_H_ */
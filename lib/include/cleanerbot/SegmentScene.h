@@ -0,0 +1,140 @@
+/*
+ * @file SegmentScene.h
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#ifndef SEGMENTSCENE_H_
+#define SEGMENTSCENE_H_
+
+#include <vector>
+#include <cstddef>
+#include "cleanerbot/Boundary.h"
+#include "cleanerbot/PolygonArena.h"
+
+/**
+ * Diese Klasse enthlt die Kanten (Strecken) von Begrenzungen in einer
+ * "vorverarbeiteten" Form. Anfangspunkt und Richtungsvektor aller Kanten
+ * werden in jeweils einem zusammenhngenden Feld pro Koordinate abgelegt
+ * (x0, y0, dx, dy). Die Berechnung der Entfernung zu einem Strahl ist damit
+ * eine einfache Schleife ber diese Felder, die ohne Speicheranforderungen
+ * auskommt und mehrere Kanten gleichzeitig prft (s. RayKernel).
+ */
+class SegmentScene: public Boundary {
+	friend class SegmentBVH;
+	friend class SegmentGrid;
+	friend class ClearanceField;
+
+private:
+	std::vector<Scalar> x0s;
+	std::vector<Scalar> y0s;
+	std::vector<Scalar> dxs;
+	std::vector<Scalar> dys;
+
+public:
+	/**
+	 * Erzeugt eine leere Szene.
+	 */
+	SegmentScene();
+	virtual ~SegmentScene();
+
+	/**
+	 * Fgt die bergebene Strecke zu der Szene hinzu.
+	 */
+	void add (const Segment2D& segment);
+
+	/**
+	 * Fgt alle Kanten des bergebenen Polygons (ein Polygon2D oder ein
+	 * Polygon einer PolygonArena) zu der Szene hinzu.
+	 */
+	void add (const PolygonRef& polygon);
+
+	/**
+	 * Fgt alle Kanten der bergebenen Szene zu dieser Szene hinzu.
+	 */
+	void add (const SegmentScene& scene);
+
+	/**
+	 * Entfernt alle Kanten aus der Szene.
+	 */
+	void clear ();
+
+	/**
+	 * Liefert die Anzahl der Kanten in der Szene.
+	 */
+	size_t size () const;
+
+	/**
+	 * Berechnet die Entfernung vom Anfangspunkt des bergebenen Strahls
+	 * bis zum ersten Schnittpunkt mit einer Kante der Szene.
+	 */
+	virtual Scalar distance (const Ray2D& ray) const;
+
+	/**
+	 * Bestimmt die Entfernungen fr einen Fcher von Strahlen
+	 * (s. Boundary#scan). Fr jede Kante wird einmal der vom Ursprung
+	 * aus sichtbare Winkelbereich bestimmt. Die Kante wird dann nur mit
+	 * den Strahlen in diesem Winkelbereich geschnitten (liegt der
+	 * Ursprung auf der Geraden durch die Kante, mit allen). Die Schnitte
+	 * werden wie bei #distance mit dem RayKernel berechnet, die
+	 * Ergebnisse stimmen daher genau mit denen einzelner Strahlen
+	 * berein.
+	 */
+	virtual void scan (const Point2D& origin, Scalar firstAngle,
+			           Scalar angleStep, size_t count,
+			           Scalar distances[]) const;
+
+	/**
+	 * Berechnet fr die Kanten mit den Indizes <code>first</code> bis
+	 * <code>last - 1</code> die Entfernung vom Punkt (ox; oy) in
+	 * Richtung des Einheitsvektors (rx; ry) bis zum ersten Schnittpunkt.
+	 * Es werden nur Schnittpunkte bercksichtigt, die nher als
+	 * <code>maxDist</code> liegen. Gibt es keinen solchen Schnittpunkt,
+	 * so wird <code>maxDist</code> zurckgeliefert.
+	 */
+	Scalar distance (Scalar ox, Scalar oy, Scalar rx, Scalar ry,
+			         size_t first, size_t last, Scalar maxDist) const;
+
+	/**
+	 * Berechnet fr die Kanten mit den Indizes <code>first</code> bis
+	 * <code>last - 1</code> die Strecke, die ein Kreis mit dem Radius
+	 * <code>radius</code> und dem Mittelpunkt (ox; oy) in Richtung des
+	 * Einheitsvektors (rx; ry) zurcklegen kann, bis er eine Kante
+	 * berhrt. Es werden nur Berhrungen bercksichtigt, die nher als
+	 * <code>maxDist</code> liegen. Gibt es keine solche Berhrung, so
+	 * wird <code>maxDist</code> zurckgeliefert. Anderenfalls wird
+	 * <code>normal</code> auf den Einheitsvektor gesetzt, der im
+	 * Berhrpunkt von der Kante zum Mittelpunkt des Kreises zeigt.
+	 *
+	 * berlappt der Kreis bereits zu Beginn eine Kante, so ist die
+	 * Strecke 0, wenn er sich weiter in die Kante hinein bewegt. Bewegt
+	 * er sich von ihr weg, wird die Kante ignoriert.
+	 */
+	Scalar sweep (Scalar ox, Scalar oy, Scalar rx, Scalar ry, Scalar radius,
+			      size_t first, size_t last, Scalar maxDist,
+			      Vector2D& normal) const;
+
+	/**
+	 * Berechnet die Strecke, die ein Kreis mit dem Radius
+	 * <code>radius</code> vom Anfangspunkt des Strahls aus in dessen
+	 * Richtung zurcklegen kann, bis er eine Kante der Szene berhrt
+	 * (s. oben).
+	 */
+	Scalar sweep (const Ray2D& path, Scalar radius, Scalar maxDist,
+			      Vector2D& normal) const;
+
+	/**
+	 * Berechnet den (krzesten) Abstand des Punktes (px; py) von der
+	 * Kante mit dem Index <code>index</code>.
+	 */
+	Scalar edgeDistance (size_t index, Scalar px, Scalar py) const;
+
+	/**
+	 * Berechnet den Abstand des Punktes (px; py) von der nchsten Kante
+	 * der Szene. Ist die Szene leer, so wird der grte darstellbare
+	 * Wert zurckgeliefert.
+	 */
+	Scalar clearance (Scalar px, Scalar py) const;
+};
+
+#endif /* SEGMENTSCENE_H_ */
@@ -11,18 +11,31 @@
 
 #include <list>
 #include "cleanerbot/Boundary.h"
+#include "cleanerbot/PolygonArena.h"
+#include "cleanerbot/SegmentScene.h"
 
 /**
  * Diese Klasse reprsentiert eine Wand (Mauer) eines Raumes.
  * Wnde knnen generell beliebige Formen annehmen. Im einfachsten Fall
  * ist die Form einer Wand ein (langgezogenes) Reckteck. Dieser Typ
  * von Wand kann direkt mit dem Konstruktor
- * #Wall(const Point2D& end1,const Point2D& end2,double thickness)
+ * #Wall(const Point2D& end1,const Point2D& end2,Scalar thickness)
  * erzeugt werden.
+ *
+ * Die Ecken aller Polygone einer Wand werden zusammenhngend in einer
+ * PolygonArena abgelegt.
  */
 class Wall: public Boundary {
+public:
+	/**
+	 * Eine Sicht auf die Polygone der Wand (s. #shapeRange).
+	 */
+	typedef PolygonArena::Range ShapeRange;
+
 private:
-	std::list<Polygon2D> shape;
+	PolygonArena shape;
+	SegmentScene segments;
+	bool baked;
 
 public:
 	/**
@@ -49,32 +62,63 @@ public:
 	 * (10.5; 0.5) und (10.5; -0.5) beschrieben wird.
 	 *
 	 */
-	Wall(const Point2D& end1, const Point2D& end2, double thickness = 0.12);
+	Wall(const Point2D& end1, const Point2D& end2, Scalar thickness = 0.12);
 	virtual ~Wall();
 
 	/**
 	 * Erweitert die Wand um die durch das Polygon beschriebene Grundflche.
 	 */
-	void addShape (const Polygon2D& shape);
+	void addShape (const PolygonRef& shape);
 
 	/**
 	 * Erweitert die Wand um das durch Endpunkte und Dicke beschriebene
 	 * Rechteck. Siehe
-	 * #Wall(const Point2D& end1,const Point2D& end2,double thickness).
+	 * #Wall(const Point2D& end1,const Point2D& end2,Scalar thickness).
 	 */
 	void addSection (const Point2D& end1, const Point2D& end2,
-			         double thickness = 0.12);
+			         Scalar thickness = 0.12);
 
 	/**
-	 * Liefert alle Polygone, die zusammen die Grundflche der Wand bilden.
+	 * Liefert eine Kopie aller Polygone, die zusammen die Grundflche
+	 * der Wand bilden.
 	 */
 	std::list<Polygon2D> getShape() const;
 
+	/**
+	 * Liefert alle Polygone, die zusammen die Grundflche der Wand
+	 * bilden, ohne sie zu kopieren. Die Sicht ist gltig, bis die Wand
+	 * verndert oder zerstrt wird.
+	 */
+	ShapeRange shapeRange() const;
+
+	/**
+	 * Ersetzt die Kanten der Wand durch den Rand der Vereinigung ihrer
+	 * Polygone (s. PolygonUnion). berlappen sich die Polygone, wie bei
+	 * mit #addSection zusammengesetzten Wnden, entfallen dadurch die
+	 * innen liegenden Kanten. Die mit #getShape gelieferten Polygone
+	 * bleiben unverndert. Room#bake ruft die Methode fr alle Wnde auf.
+	 */
+	void bake ();
+
+	/**
+	 * Liefert die Kanten aller Polygone der Wand in der fr die
+	 * Entfernungsberechnung vorverarbeiteten Form (nach #bake den Rand
+	 * der Vereinigung der Polygone).
+	 */
+	const SegmentScene& getSegments() const;
+
 	/**
 	 * Berechnet die Entfernung vom Anfangspunkt des bergebenen Strahls
 	 * bis zum ersten Schnittpunkt mit dieser Wand.
 	 */
-	double distance (const Ray2D& ray) const;
+	Scalar distance (const Ray2D& ray) const;
+
+	/**
+	 * Bestimmt die Entfernungen fr einen Fcher von Strahlen
+	 * (s. Boundary#scan).
+	 */
+	void scan (const Point2D& origin, Scalar firstAngle, Scalar angleStep,
+			   size_t count, Scalar distances[]) const;
 };
 
 #endif /* WALL_H_ */
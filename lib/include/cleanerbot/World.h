@@ -42,8 +42,13 @@
 
 #include <string>
 #include <sstream>
+#include <memory>
+#include <atomic>
+#include <future>
+#include <chrono>
 #include "cleanerbot/Room.h"
-#include "../util/Socket.h"
+#include "cleanerbot/CommandSink.h"
+#include "cleanerbot/CommandChannel.h"
 
 using std::string;
 using std::stringstream;
@@ -60,23 +65,89 @@ using std::stringstream;
  *
  * Die Implementierung versucht sich beim Erzeugen mit dem
  * unabhngig laufenden Anzeige-Server zu verbinden und verwendet ihn, wenn
- * verfgbar, fr die Visualisierung.
+ * verfgbar, fr die Visualisierung. Eine mit
+ * #World(Headless, CommandSink*) erzeugte Welt verwendet dagegen keinen
+ * Anzeige-Server (z.&nbsp;B. fr Simulationen).
+ *
+ * Die Kommandos an den Anzeige-Server werden ber einen CommandChannel
+ * gesendet, ohne auf die Antworten zu warten. #show, #showStatus und
+ * #setRoom kehren daher zurck, bevor der Server das Kommando
+ * bearbeitet hat. Nur #getKey wartet auf die Antwort (bzw. liefert sie
+ * mit #getKeyAsync als <code>std::future</code>). Untersttzt der
+ * Anzeige-Server das binre Protokoll des CommandChannel, werden
+ * Positionen und Wnde ohne Umwandlung in Text bertragen.
+ *
+ * Da die Anzeige nur eine begrenzte Anzahl von Bildern pro Sekunde
+ * darstellen kann, sendet #show hchstens einmal pro Bild (s.
+ * #setDisplayRate) ein Kommando. Dazwischen wird nur die jeweils
+ * letzte Position gemerkt und am Ende des Bilds (vom Ein-/Ausgabe-Thread
+ * des CommandChannel), vor dem nchsten anderen Kommando oder mit
+ * #flushShow gesendet. Werden die Kommandos protokolliert
+ * (#setTraceCommands) oder an einen CommandSink bergeben, wartet die
+ * gemerkte Position dagegen auf den nchsten Aufruf von #show, das
+ * nchste andere Kommando oder #flushShow.
+ *
+ * Der Raum wird als unvernderlicher Schnappschuss (einschlielich der
+ * Suchstrukturen) von allen Kopien einer Welt gemeinsam genutzt. Der
+ * Speicherbedarf hngt damit nur von der Anzahl der verschiedenen Rume
+ * ab, nicht von der Anzahl der Kopien (z.&nbsp;B. eine pro Saugroboter).
+ * Verndert eine Welt ihren Raum (#addWall), erhlt sie vorher eine
+ * eigene Kopie, falls der Raum jemals mit anderen Welten geteilt wurde
+ * (copy-on-write).
+ *
+ * Die konstanten Abfragen (#distanceFront, #distanceLeft,
+ * #distanceRight, #scan, #sweep, #clearance und #clearanceGradient)
+ * drfen fr dieselbe Welt gleichzeitig aus beliebig vielen Threads
+ * aufgerufen werden. Sie lesen nur den unvernderlichen Raum, fordern
+ * keinen Speicher an und verwenden keine Sperren. Alle anderen Methoden,
+ * insbesondere #setRoom, #addWall und die Methoden, die mit dem
+ * Anzeige-Server kommunizieren, drfen nicht gleichzeitig mit anderen
+ * Aufrufen fr dieselbe Welt erfolgen. Kopien einer Welt knnen dagegen
+ * ohne Einschrnkung (auch mit #addWall) in verschiedenen Threads
+ * verwendet und zerstrt werden, da alle gemeinsam genutzten Zhler
+ * atomar sind und ein einmal geteilter Raum nie verndert wird.
  */
 class World {
 private:
-	SocketClient* cmdCon;
-	int* refCounter;
+	CommandChannel* cmdCon;
+	std::atomic<int>* refCounter;
+	CommandSink* sink;
 	bool traceCommands;
-	int sendCommand (const string& cmd);
-	int sendCommand (stringstream& cmd);
-	int sendCommand(const string& cmd, string& rest);
-	int sendCommand(stringstream& cmd, string& rest);
+
+	// Rate limiting of show (per world, i.e. per robot)
+	std::chrono::steady_clock::duration frameInterval;
+	std::chrono::steady_clock::time_point lastShow;
+	bool showPending;
+	double pendingX, pendingY, pendingAngle, pendingDiameter;
+	unsigned long showsSent;
+	unsigned long showsCoalesced;
+	void initShow ();
+	void sendShow (double positionX, double positionY, double angle,
+				   double diameter);
+
+	bool hasReceiver () const;
+	bool postsDirectly () const;
+	void sendCommand (const string& cmd);
+	void sendCommand (stringstream& cmd);
 	void decRefCounter ();
 
-	const Room* room;
-	double distToRoom (const Ray2D& ray) const;
+	std::shared_ptr<const Room> room;
+	// Room created by this world and never shared, cleared (possibly
+	// by several threads) when the world is copied
+	mutable std::atomic<bool> ownsRoom;
+	Scalar distToRoom (const Ray2D& ray) const;
+	Room& modifiableRoom ();
+	void sendScene ();
 
 public:
+	/**
+	 * Kennzeichnet den Konstruktor fr eine Welt ohne Anzeige-Server.
+	 */
+	enum Headless {
+		/** Welt ohne Verbindung zum Anzeige-Server. */
+		HEADLESS
+	};
+
 	/**
 	 * Erzeugt eine neue Welt, in der sich der Staubsauger bewegen kann.
 	 * Dabei wird versucht, eine Verbindung zu einem Anzeige-Server auf
@@ -89,6 +160,21 @@ public:
 	 */
 	World(string host = "localhost", int port = 23454);
 
+	/**
+	 * Erzeugt eine neue Welt ohne Anzeige-Server, z.&nbsp;B. fr
+	 * Simulationen mit vielen Saugrobotern. Es wird weder eine Verbindung
+	 * aufgebaut noch Speicher angefordert. Alle Kommandos an die Anzeige
+	 * werden an den bergebenen Empfnger weitergeleitet, der von allen
+	 * Kopien der Welt gemeinsam verwendet wird und lnger als diese
+	 * existieren muss. Ohne Empfnger kehren #show, #showStatus und die
+	 * Anzeige des Raums in #setRoom sofort zurck, ohne ein Kommando zu
+	 * erzeugen. #getKey liefert in beiden Fllen eine leere
+	 * Zeichenkette.
+	 *
+	 * Beispiel: <code>World world(World::HEADLESS);</code>
+	 */
+	explicit World(Headless headless, CommandSink* sink = NULL);
+
     /**
      * Erzeugt ein neues Objekt als Kopie des bergebenen Objekts.
      */
@@ -138,6 +224,36 @@ public:
     virtual void show(double positionX, double positionY, double angle,
     		          double diameter = 0.4);
 
+	/**
+	 * Sendet die von #show gemerkte, noch nicht angezeigte Position
+	 * sofort. Das geschieht auch automatisch vor allen anderen Kommandos
+	 * an die Anzeige und beim Zerstren der Welt.
+	 */
+	void flushShow ();
+
+	/**
+	 * Setzt die Anzahl der Bilder pro Sekunde, mit der die Anzeige
+	 * hchstens aktualisiert wird (Vorgabe: 60). Aufrufe von #show, die
+	 * innerhalb desselben Bilds erfolgen, werden zusammengefasst, nur die
+	 * letzte Position wird gesendet. Mit 0 wird jeder Aufruf sofort
+	 * gesendet. Statuszeile und Raum werden nie zusammengefasst.
+	 *
+	 * @param framesPerSecond die Anzahl der Bilder pro Sekunde.
+	 */
+	void setDisplayRate (double framesPerSecond);
+
+	/**
+	 * Liefert die Anzahl der Aufrufe von #show, fr die ein Kommando an
+	 * die Anzeige gesendet wurde.
+	 */
+	unsigned long getShowsSent () const;
+
+	/**
+	 * Liefert die Anzahl der Aufrufe von #show, deren Position durch
+	 * eine sptere Position ersetzt und daher nicht gesendet wurde.
+	 */
+	unsigned long getShowsCoalesced () const;
+
 	/**
 	 * Zeigt dem Benutzer in der Statuszeile den bergebenen Text an.
 	 * @param statusText der anzuzeigende Text.
@@ -162,6 +278,16 @@ public:
 	 */
 	virtual string getKey();
 
+	/**
+	 * Fordert wie #getKey die nchste im Konsolenfenster gedrckte Taste
+	 * an, wartet aber nicht auf das Ergebnis. Die Taste kann spter mit
+	 * <code>get()</code> abgefragt werden, bis dahin knnen weitere
+	 * Kommandos an den Anzeige-Server gesendet werden.
+	 *
+	 * @return die gedrckte Taste, sobald sie bekannt ist.
+	 */
+	std::future<string> getKeyAsync();
+
     /**
      * Bestimmt die Entfernung zwischen der Vorderseite eines Staubsaugers
      * mit den bergebenen Eigenschaftem
@@ -173,8 +299,8 @@ public:
      * und der x-Achse im Bogenma (rad).
      * @param diameter der Durchmesser des Staubsaugers in Metern.
      */
-	double distanceFront (double positionX, double positionY, double angle,
-	          	  	  	  double diameter = 0.4) const;
+	Scalar distanceFront (Scalar positionX, Scalar positionY, Scalar angle,
+	          	  	  	  Scalar diameter = 0.4) const;
 
     /**
      * Bestimmt die Entfernung zwischen der linken Seite eines Staubsaugers
@@ -187,8 +313,8 @@ public:
      * und der x-Achse im Bogenma (rad).
      * @param diameter der Durchmesser des Staubsaugers in Metern.
      */
-	double distanceLeft (double positionX, double positionY, double angle,
-	          	  	     double diameter = 0.4) const;
+	Scalar distanceLeft (Scalar positionX, Scalar positionY, Scalar angle,
+	          	  	     Scalar diameter = 0.4) const;
 
     /**
      * Bestimmt die Entfernung zwischen der rechten Seite eines Staubsaugers
@@ -201,14 +327,110 @@ public:
      * und der x-Achse im Bogenma (rad).
      * @param diameter der Durchmesser des Staubsaugers in Metern.
      */
-	double distanceRight (double positionX, double positionY, double angle,
-	          	  	  	  double diameter = 0.4) const;
+	Scalar distanceRight (Scalar positionX, Scalar positionY, Scalar angle,
+	          	  	  	  Scalar diameter = 0.4) const;
+
+    /**
+     * Bestimmt die Entfernungen zwischen dem Rand eines Staubsaugers
+     * mit den bergebenen Eigenschaften und den nchsten Hindernissen im
+     * Raum fr einen Fcher von Strahlen (simulierter Laserscanner).
+     *
+     * Der Fcher mit dem ffnungswinkel <code>fov</code> wird in
+     * <code>nRays</code> gleich groe Sektoren aufgeteilt, in deren
+     * Mitte jeweils ein Strahl liegt. Der Strahl mit dem Index i hat
+     * damit den Winkel
+     * <code>angle - fov/2 + (i + 0.5) * fov/nRays</code>.
+     * Fr einen Rundumblick wird <code>fov = 2 * M_PI</code> bergeben.
+     *
+     * Alle Strahlen werden gemeinsam berechnet (s. Room#scan), die
+     * Ergebnisse werden ohne Speicheranforderungen in das vom Aufrufer
+     * bereitgestellte Feld geschrieben.
+     *
+     * @param positionX die Position des Staubsaugers auf der x-Achse.
+     * @param positionY die Position des Staubsaugers auf der y-Achse.
+     * @param angle der Winkel zwischen der Fahrtrichtung des Staubsaugers
+     * und der x-Achse im Bogenma (rad).
+     * @param fov der ffnungswinkel des Fchers im Bogenma (rad).
+     * @param nRays die Anzahl der Strahlen.
+     * @param distances das Feld fr die Ergebnisse, es muss mindestens
+     * <code>nRays</code> Elemente haben.
+     * @param diameter der Durchmesser des Staubsaugers in Metern.
+     */
+	void scan (Scalar positionX, Scalar positionY, Scalar angle, Scalar fov,
+			   int nRays, Scalar distances[], Scalar diameter = 0.4) const;
+
+    /**
+     * Bestimmt, wie weit sich ein Staubsauger mit den bergebenen
+     * Eigenschaften in Fahrtrichtung bewegen kann, bevor er eine Wand
+     * berhrt. Die Bewegung wird dabei kontinuierlich geprft, auch
+     * dnne Wnde werden bei groen Schritten nicht bersprungen
+     * (s. Room#sweep).
+     *
+     * @param positionX die Position des Staubsaugers auf der x-Achse.
+     * @param positionY die Position des Staubsaugers auf der y-Achse.
+     * @param angle der Winkel zwischen der Fahrtrichtung des Staubsaugers
+     * und der x-Achse im Bogenma (rad).
+     * @param distance die Lnge der beabsichtigten Bewegung.
+     * @param normal wird bei einer Berhrung auf den Einheitsvektor
+     * gesetzt, der von der Wand weg zeigt.
+     * @param diameter der Durchmesser des Staubsaugers in Metern.
+     * @return die mgliche Lnge der Bewegung (hchstens
+     * <code>distance</code>).
+     */
+	Scalar sweep (Scalar positionX, Scalar positionY, Scalar angle,
+			      Scalar distance, Vector2D& normal,
+			      Scalar diameter = 0.4) const;
+
+    /**
+     * Bestimmt den Abstand zwischen dem Rand eines Staubsaugers an der
+     * bergebenen Position und der nchsten Wand, unabhngig von der
+     * Richtung. Ein negativer Wert bedeutet eine Kollision.
+     *
+     * Wurde fr den Raum vor dem Aufruf von #setRoom ein Abstandsfeld
+     * aufgebaut (s. Room#buildClearance), hat die Abfrage konstanten
+     * Aufwand.
+     *
+     * @param positionX die Position des Staubsaugers auf der x-Achse.
+     * @param positionY die Position des Staubsaugers auf der y-Achse.
+     * @param diameter der Durchmesser des Staubsaugers in Metern.
+     */
+	Scalar clearance (Scalar positionX, Scalar positionY,
+			          Scalar diameter = 0.4) const;
 
     /**
-     * Legt den zu der Welt gehrenden Raum fest.
+     * Liefert die Richtung, in der der Abstand zur nchsten Wand an der
+     * bergebenen Position am strksten zunimmt (s. Room#clearanceGradient).
+     *
+     * @param positionX die Position auf der x-Achse.
+     * @param positionY die Position auf der y-Achse.
+     */
+	Vector2D clearanceGradient (Scalar positionX, Scalar positionY) const;
+
+    /**
+     * Legt den zu der Welt gehrenden Raum fest. Die Welt verwendet eine
+     * Kopie des Raums, fr die Room#bake aufgerufen wird. Der bisherige
+     * Raum wird freigegeben, sobald ihn keine Kopie der Welt mehr
+     * verwendet.
      * @param room der Raum.
      */
     virtual void setRoom(const Room& room);
+
+    /**
+     * Fgt die bergebene Wand zum Raum dieser Welt hinzu. Wird der Raum
+     * noch von anderen Kopien der Welt verwendet, wird er vorher kopiert,
+     * die anderen Welten sehen die nderung nicht. Der vernderte Raum
+     * wird anschlieend vorbereitet (Room#bake) und neu angezeigt.
+     * @param wall die Wand.
+     */
+    void addWall(const Wall& wall);
+
+    /**
+     * Liefert den aktuellen Raum der Welt (oder einen leeren Zeiger, wenn
+     * kein Raum festgelegt wurde). Der gelieferte Schnappschuss bleibt
+     * unverndert und gltig, auch wenn die Welt danach ihren Raum
+     * verndert oder ersetzt.
+     */
+    std::shared_ptr<const Room> getRoom() const;
 };
 
 #endif /* VACUUMCLEANERWORLD_H_ */
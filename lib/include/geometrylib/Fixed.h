@@ -0,0 +1,476 @@
+/*
+ * @file Fixed.h
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#ifndef FIXED_H_
+#define FIXED_H_
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+
+namespace GeometryLib {
+
+/**
+ * This class models a signed Q16.16 fixed-point number, i.e. a 32 bit
+ * integer with 16 fractional bits. The range is [-32768, 32768) with a
+ * resolution of 1/65536 (about 15 micrometres for coordinates in metres).
+ *
+ * All operations use integer arithmetic only, so the class can be used
+ * as data type for the geometry templates on processors without a
+ * floating point unit. Results that are out of range saturate at
+ * the minimum or maximum value; division by zero yields the maximum
+ * (or minimum) value.
+ *
+ * Instances can be created implicitly from integral and floating point
+ * values, but are converted back only explicitly (using static_cast),
+ * so that no floating point arithmetic is used inadvertently.
+ */
+class Fixed {
+private:
+	int32_t value;
+
+	struct Raw {};
+	constexpr Fixed(int32_t raw, Raw) : value(raw) {
+	}
+
+	static constexpr int32_t saturate (int64_t raw) {
+		return raw > INT32_MAX ? INT32_MAX
+			: raw < INT32_MIN ? INT32_MIN : int32_t(raw);
+	}
+
+	static constexpr int32_t fromDouble (double v) {
+		return !(v == v) ? 0
+			: v >= 32768.0 ? INT32_MAX
+			: v <= -32768.0 ? INT32_MIN
+			: saturate(int64_t(v * ONE + (v < 0 ? -0.5 : 0.5)));
+	}
+
+public:
+	/** The number of fractional bits. */
+	static const int FRACTION_BITS = 16;
+	/** The raw value that represents 1. */
+	static const int32_t ONE = 1 << FRACTION_BITS;
+
+	/**
+	 * Initialize a new number with the value 0.
+	 */
+	constexpr Fixed() : value(0) {
+	}
+
+	/**
+	 * Initialize a new number with the given integral value.
+	 *
+	 * @param v the value
+	 */
+	template <class I, typename std::enable_if
+		<std::is_integral<I>::value, int>::type = 0>
+	constexpr Fixed(I v) : value(saturate(int64_t(v) * ONE)) {
+	}
+
+	/**
+	 * Initialize a new number with the given value, rounded to the
+	 * nearest representable value.
+	 *
+	 * @param v the value
+	 */
+	constexpr Fixed(double v) : value(fromDouble(v)) {
+	}
+
+	/**
+	 * Return the number with the given raw (scaled) value.
+	 *
+	 * @param raw the raw value
+	 * @return the number
+	 */
+	static constexpr Fixed fromRaw (int32_t raw) {
+		return Fixed(raw, Raw());
+	}
+
+	/**
+	 * Return the raw (scaled) value.
+	 *
+	 * @return the raw value
+	 */
+	constexpr int32_t raw () const {
+		return value;
+	}
+
+	/**
+	 * Convert the number to an arithmetic type. Conversion to an
+	 * integral type rounds towards negative infinity.
+	 *
+	 * @return the converted value
+	 */
+	template <class N, typename std::enable_if
+		<std::is_arithmetic<N>::value, int>::type = 0>
+	explicit constexpr operator N () const {
+		return std::is_integral<N>::value ? N(value >> FRACTION_BITS)
+			: N(N(value) / N(ONE));
+	}
+
+	constexpr Fixed operator- () const {
+		return fromRaw(saturate(-int64_t(value)));
+	}
+
+	friend constexpr Fixed operator+ (Fixed a, Fixed b) {
+		return fromRaw(saturate(int64_t(a.value) + b.value));
+	}
+
+	friend constexpr Fixed operator- (Fixed a, Fixed b) {
+		return fromRaw(saturate(int64_t(a.value) - b.value));
+	}
+
+	friend constexpr Fixed operator* (Fixed a, Fixed b) {
+		return fromRaw(saturate((int64_t(a.value) * b.value
+								 + (ONE >> 1)) >> FRACTION_BITS));
+	}
+
+	friend constexpr Fixed operator/ (Fixed a, Fixed b) {
+		return b.value == 0
+			? fromRaw(a.value > 0 ? INT32_MAX : a.value < 0 ? INT32_MIN : 0)
+			: fromRaw(saturate((int64_t(a.value) << FRACTION_BITS) / b.value));
+	}
+
+	Fixed& operator+= (Fixed other) {
+		return *this = *this + other;
+	}
+
+	Fixed& operator-= (Fixed other) {
+		return *this = *this - other;
+	}
+
+	Fixed& operator*= (Fixed other) {
+		return *this = *this * other;
+	}
+
+	Fixed& operator/= (Fixed other) {
+		return *this = *this / other;
+	}
+
+	friend constexpr bool operator== (Fixed a, Fixed b) {
+		return a.value == b.value;
+	}
+
+	friend constexpr bool operator!= (Fixed a, Fixed b) {
+		return a.value != b.value;
+	}
+
+	friend constexpr bool operator< (Fixed a, Fixed b) {
+		return a.value < b.value;
+	}
+
+	friend constexpr bool operator<= (Fixed a, Fixed b) {
+		return a.value <= b.value;
+	}
+
+	friend constexpr bool operator> (Fixed a, Fixed b) {
+		return a.value > b.value;
+	}
+
+	friend constexpr bool operator>= (Fixed a, Fixed b) {
+		return a.value >= b.value;
+	}
+
+	/**
+	 * Return the quotient of two products (e.g. cross products of
+	 * vectors with Fixed components, evaluated with int64_t). The
+	 * quotient is computed by long division, so no intermediate
+	 * result needs more than 64 bits. The result is truncated
+	 * towards zero.
+	 *
+	 * @param num the numerator (a sum of products of raw values)
+	 * @param den the denominator (a sum of products of raw values)
+	 * @return the quotient
+	 */
+	static Fixed quotient (int64_t num, int64_t den) {
+		if (den == 0) {
+			return fromRaw(num > 0 ? INT32_MAX : num < 0 ? INT32_MIN : 0);
+		}
+		bool negative = (num < 0) != (den < 0);
+		uint64_t n = num < 0 ? 0 - uint64_t(num) : uint64_t(num);
+		uint64_t d = den < 0 ? 0 - uint64_t(den) : uint64_t(den);
+		uint64_t q = n / d;
+		if (q >= uint64_t(1) << (31 - FRACTION_BITS)) {
+			return fromRaw(negative ? INT32_MIN : INT32_MAX);
+		}
+		uint64_t r = n % d;
+		for (int bit = 0; bit < FRACTION_BITS; bit++) {
+			// r < d, so doubling only overflows for d >= 2^63
+			r <<= 1;
+			q <<= 1;
+			if (r >= d) {
+				r -= d;
+				q |= 1;
+			}
+		}
+		return fromRaw(negative ? -int32_t(q) : int32_t(q));
+	}
+};
+
+/**
+ * Return the absolute value.
+ */
+inline Fixed abs (Fixed x) {
+	return x < 0 ? -x : x;
+}
+
+/**
+ * Return the largest integral value not greater than x.
+ */
+inline Fixed floor (Fixed x) {
+	return Fixed::fromRaw(x.raw() & ~(Fixed::ONE - 1));
+}
+
+/**
+ * Return the smallest integral value not less than x.
+ */
+inline Fixed ceil (Fixed x) {
+	return -floor(-x);
+}
+
+/**
+ * Return the remainder of x / y with the sign of x (like std::fmod).
+ */
+inline Fixed fmod (Fixed x, Fixed y) {
+	// INT32_MIN % -1 overflows, every value is a multiple of the
+	// smallest step anyway
+	if (y == 0 || y.raw() == -1) {
+		return Fixed();
+	}
+	return Fixed::fromRaw(x.raw() % y.raw());
+}
+
+/** \cond */
+namespace FixedImpl {
+
+// Integer square root (rounded down), bit by bit
+inline uint64_t isqrt (uint64_t n) {
+	uint64_t res = 0;
+	uint64_t bit = uint64_t(1) << 62;
+	while (bit > n) {
+		bit >>= 2;
+	}
+	while (bit != 0) {
+		if (n >= res + bit) {
+			n -= res + bit;
+			res = (res >> 1) + bit;
+		} else {
+			res >>= 1;
+		}
+		bit >>= 2;
+	}
+	return res;
+}
+
+// Angles and coordinates are processed with 30 fractional bits
+const int BITS = 30;
+const int STEPS = 30;
+const int64_t PI = 3373259426LL;
+const int64_t HALF_PI = 1686629713LL;
+const int64_t TWO_PI = 6746518852LL;
+// Product of the CORDIC gain factors 1 / sqrt(1 + 2^-2i)
+const int64_t GAIN = 652032874LL;
+// atan(2^-i)
+const int64_t ATAN[STEPS] = {
+	843314857, 497837829, 263043837, 133525159, 67021687, 33543516,
+	16775851, 8388437, 4194283, 2097149, 1048576, 524288, 262144, 131072,
+	65536, 32768, 16384, 8192, 4096, 2048, 1024, 512, 256, 128, 64, 32,
+	16, 8, 4, 2 };
+
+inline Fixed toFixed (int64_t v) {
+	const int shift = BITS - Fixed::FRACTION_BITS;
+	return Fixed::fromRaw(int32_t((v + (int64_t(1) << (shift - 1))) >> shift));
+}
+
+inline void sinCos (Fixed angle, Fixed& sine, Fixed& cosine) {
+	int64_t z = (int64_t(angle.raw()) << (BITS - Fixed::FRACTION_BITS))
+		% TWO_PI;
+	if (z > PI) {
+		z -= TWO_PI;
+	} else if (z < -PI) {
+		z += TWO_PI;
+	}
+	// Rotation mode converges for |z| < 1.74, use symmetry for the rest
+	bool flip = false;
+	if (z > HALF_PI) {
+		z -= PI;
+		flip = true;
+	} else if (z < -HALF_PI) {
+		z += PI;
+		flip = true;
+	}
+	int64_t x = GAIN;
+	int64_t y = 0;
+	for (int i = 0; i < STEPS; i++) {
+		int64_t nx;
+		if (z >= 0) {
+			nx = x - (y >> i);
+			y += x >> i;
+			z -= ATAN[i];
+		} else {
+			nx = x + (y >> i);
+			y -= x >> i;
+			z += ATAN[i];
+		}
+		x = nx;
+	}
+	sine = toFixed(flip ? -y : y);
+	cosine = toFixed(flip ? -x : x);
+}
+
+}
+/** \endcond */
+
+/**
+ * Return the square root (rounded down), or 0 for negative values.
+ */
+inline Fixed sqrt (Fixed x) {
+	if (x <= 0) {
+		return Fixed();
+	}
+	return Fixed::fromRaw(int32_t(FixedImpl::isqrt
+		(uint64_t(x.raw()) << Fixed::FRACTION_BITS)));
+}
+
+/**
+ * Return sqrt(x*x + y*y) (rounded down). Unlike the expression,
+ * the function does not overflow if x*x or y*y exceed the range.
+ */
+inline Fixed hypot (Fixed x, Fixed y) {
+	uint64_t sum = uint64_t(int64_t(x.raw()) * x.raw())
+		+ uint64_t(int64_t(y.raw()) * y.raw());
+	uint64_t res = FixedImpl::isqrt(sum);
+	return Fixed::fromRaw(res > INT32_MAX ? INT32_MAX : int32_t(res));
+}
+
+/**
+ * Return the sine of the given angle (computed using CORDIC).
+ */
+inline Fixed sin (Fixed angle) {
+	Fixed s, c;
+	FixedImpl::sinCos(angle, s, c);
+	return s;
+}
+
+/**
+ * Return the cosine of the given angle (computed using CORDIC).
+ */
+inline Fixed cos (Fixed angle) {
+	Fixed s, c;
+	FixedImpl::sinCos(angle, s, c);
+	return c;
+}
+
+/**
+ * Return the angle between the x-axis and the vector (x; y) in the
+ * range [-pi, pi] (computed using CORDIC).
+ */
+inline Fixed atan2 (Fixed y, Fixed x) {
+	using namespace FixedImpl;
+	int64_t vx = x.raw();
+	int64_t vy = y.raw();
+	if (vx == 0 && vy == 0) {
+		return Fixed();
+	}
+	// Scale up for precision, the gain (1.65) must still fit
+	while (std::abs(vx) < (int64_t(1) << BITS)
+		   && std::abs(vy) < (int64_t(1) << BITS)) {
+		vx <<= 1;
+		vy <<= 1;
+	}
+	// Vectoring mode converges for x >= 0, rotate by 90 degrees if needed
+	int64_t z = 0;
+	if (vx < 0) {
+		int64_t t = vx;
+		if (vy >= 0) {
+			vx = vy;
+			vy = -t;
+			z = HALF_PI;
+		} else {
+			vx = -vy;
+			vy = t;
+			z = -HALF_PI;
+		}
+	}
+	for (int i = 0; i < STEPS; i++) {
+		int64_t nx;
+		if (vy > 0) {
+			nx = vx + (vy >> i);
+			vy -= vx >> i;
+			z += ATAN[i];
+		} else {
+			nx = vx - (vy >> i);
+			vy += vx >> i;
+			z -= ATAN[i];
+		}
+		vx = nx;
+	}
+	return toFixed(z);
+}
+
+/**
+ * Write the number's value to the given stream.
+ */
+inline std::ostream& operator<< (std::ostream& out, Fixed x) {
+	return out << static_cast<double>(x);
+}
+
+// The geometry templates call the mathematical functions unqualified,
+// so that the overloads above are found for Fixed and the standard
+// functions for the built-in types.
+using std::abs;
+using std::floor;
+using std::ceil;
+using std::fmod;
+using std::sqrt;
+using std::hypot;
+using std::sin;
+using std::cos;
+using std::atan2;
+
+}
+
+namespace std {
+
+/**
+ * Properties of the fixed-point type. As there is no representation
+ * of infinity, infinity() returns max(), which the geometry code uses
+ * for "no intersection".
+ */
+template <> class numeric_limits<GeometryLib::Fixed> {
+public:
+	static constexpr bool is_specialized = true;
+	static constexpr bool is_signed = true;
+	static constexpr bool is_integer = false;
+	static constexpr bool is_exact = true;
+	static constexpr bool has_infinity = false;
+	static constexpr bool has_quiet_NaN = false;
+	static constexpr int radix = 2;
+	static constexpr int digits = 31;
+
+	// Smallest positive value, as for floating point types
+	static constexpr GeometryLib::Fixed min () {
+		return GeometryLib::Fixed::fromRaw(1);
+	}
+	static constexpr GeometryLib::Fixed lowest () {
+		return GeometryLib::Fixed::fromRaw(INT32_MIN);
+	}
+	static constexpr GeometryLib::Fixed max () {
+		return GeometryLib::Fixed::fromRaw(INT32_MAX);
+	}
+	static constexpr GeometryLib::Fixed epsilon () {
+		return GeometryLib::Fixed::fromRaw(1);
+	}
+	static constexpr GeometryLib::Fixed infinity () {
+		return max();
+	}
+};
+
+}
+
+#endif /* FIXED_H_ */
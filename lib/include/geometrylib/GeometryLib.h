@@ -9,5 +9,8 @@
 #include "Point2D.h"
 #include "Ray2D.h"
 #include "Polygon2D.h"
+#include "Range.h"
 #include "Vector2D.h"
 #include "Segment2D.h"
+#include "Predicates.h"
+#include "Fixed.h"
@@ -14,6 +14,11 @@ namespace GeometryLib {
 /**
  * This template class models a point in the two dimensional space
  * using the supplied data type for storing the coordinates.
+ *
+ * Points are plain values: they are trivially copyable and have
+ * standard layout, so an array of points occupies exactly two
+ * coordinates per point and may be copied with memcpy. All
+ * constructors and accessors are constexpr.
  */
 template <class T> class Vector2D;
 
@@ -24,18 +29,19 @@ private:
 	T yCoord;
 
 public:
+	/**
+	 * Initialize a new point at the origin.
+	 */
+	constexpr Point2D() : xCoord(0), yCoord(0) {
+	}
+
 	/**
 	 * Initialize a new point with the given coordinates.
 	 *
 	 * @param x the x-axis coordinate
 	 * @param y the y-axis coordinate
 	 */
-	Point2D(T x, T y) {
-		xCoord = x;
-		yCoord = y;
-	}
-
-	virtual ~Point2D() {
+	constexpr Point2D(T x, T y) : xCoord(x), yCoord(y) {
 	}
 
 	/**
@@ -43,7 +49,7 @@ public:
 	 *
 	 * @return x-axis coordinate
 	 */
-	T x() const {
+	constexpr T x() const {
 		return xCoord;
 	}
 
@@ -52,16 +58,16 @@ public:
 	 *
 	 * @return y-axis coordinate
 	 */
-	T y() const {
+	constexpr T y() const {
 		return yCoord;
-	};
+	}
 
 	/**
 	 * Translate the point by the given vector.
 	 *
 	 * @return the point obtained by translating this point by the given vector
 	 */
-	Point2D<T> operator+ (const Vector2D<T>& vec) const {
+	constexpr Point2D<T> operator+ (const Vector2D<T>& vec) const {
 		return Point2D<T>(xCoord + vec.dx(), yCoord + vec.dy());
 	}
 
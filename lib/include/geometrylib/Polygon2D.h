@@ -9,9 +9,12 @@
 #ifndef POLYGON2D_H_
 #define POLYGON2D_H_
 
+#include <cstddef>
+#include <iterator>
 #include <vector>
 #include "geometrylib/Point2D.h"
 #include "geometrylib/Segment2D.h"
+#include "geometrylib/Range.h"
 
 namespace GeometryLib {
 
@@ -19,6 +22,13 @@ namespace GeometryLib {
  * This class models a polygon in the two dimensional space. The polygon
  * is defined by vertices of type Point2D<T>. The shape can be queried
  * by getting the vertices or the edges.
+ *
+ * The vertices are kept in a std::vector, so unlike the other classes
+ * of this library a polygon is not trivially copyable. As the vertices
+ * are trivially copyable values, they are stored densely.
+ *
+ * Neither #vertices nor #edgeRange copy or allocate anything, so they
+ * should be preferred to #edges on frequently executed paths.
  */
 template <class T>
 class Polygon2D {
@@ -26,15 +36,86 @@ private:
 	std::vector<Point2D<T> > points;
 
 public:
+	/**
+	 * A forward iterator over the edges of a polygon. The edges are
+	 * created from the polygon's vertices when the iterator is
+	 * dereferenced, so the iterator yields values rather than
+	 * references. The iterator becomes invalid when points are
+	 * added to the polygon.
+	 */
+	class EdgeIterator {
+	private:
+		const Point2D<T>* points;
+		size_t count;
+		size_t index;
+
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef Segment2D<T> value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const Segment2D<T>* pointer;
+		typedef Segment2D<T> reference;
+
+		/**
+		 * Initialize a new iterator that points to the edge starting
+		 * at the vertex with the given index.
+		 *
+		 * @param points the vertices
+		 * @param count the number of vertices
+		 * @param index the index of the edge
+		 */
+		EdgeIterator(const Point2D<T>* points, size_t count, size_t index)
+			: points(points), count(count), index(index) {
+		}
+
+		/**
+		 * Return the edge that the iterator points to.
+		 *
+		 * @return the edge
+		 */
+		Segment2D<T> operator*() const {
+			return Segment2D<T>(points[index],
+								points[index + 1 < count ? index + 1 : 0]);
+		}
+
+		/**
+		 * Advance to the next edge.
+		 *
+		 * @return the iterator
+		 */
+		EdgeIterator& operator++() {
+			index += 1;
+			return *this;
+		}
+
+		/**
+		 * Advance to the next edge.
+		 *
+		 * @return the iterator before advancing
+		 */
+		EdgeIterator operator++(int) {
+			EdgeIterator res = *this;
+			index += 1;
+			return res;
+		}
+
+		bool operator==(const EdgeIterator& other) const {
+			return index == other.index && points == other.points;
+		}
+
+		bool operator!=(const EdgeIterator& other) const {
+			return !(*this == other);
+		}
+	};
+
+	typedef Range<EdgeIterator> EdgeRange;
+
 	/**
 	 * Initialize a new polygon with no points.
 	 */
 	Polygon2D() {
 	}
 
-	virtual ~Polygon2D() {
-	}
-
 	/**
 	 * Add a point to the list of points that make the polygon's shape.
 	 *
@@ -69,11 +150,37 @@ public:
 	}
 
 	/**
-	 * Returns the list of points as added to the polygon.
+	 * Return the number of edges, i.e. the number of elements
+	 * in the result of #edges.
+	 *
+	 * @return the number of edges
+	 */
+	size_t edgeCount() const {
+		return points.size() < 2 ? 0
+			: points.size() == 2 ? 1 : points.size();
+	}
+
+	/**
+	 * Return the edges of the polygon in the same order as #edges,
+	 * but as a range that creates them from the vertices while
+	 * iterating, without allocating memory.
+	 *
+	 * @return the edges
+	 */
+	EdgeRange edgeRange() const {
+		return EdgeRange(EdgeIterator(points.data(), points.size(), 0),
+						 EdgeIterator(points.data(), points.size(),
+									  edgeCount()));
+	}
+
+	/**
+	 * Returns the list of points as added to the polygon. The
+	 * result refers to the polygon's storage and becomes invalid
+	 * when points are added to the polygon.
 	 *
 	 * @return the list of points
 	 */
-	const std::vector<Point2D<T> > vertices() const {
+	const std::vector<Point2D<T> >& vertices() const {
 		return points;
 	}
 };
@@ -0,0 +1,277 @@
+/*
+ * @file Predicates.h
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#ifndef PREDICATES_H_
+#define PREDICATES_H_
+
+#include <cmath>
+#include "geometrylib/Fixed.h"
+#include "geometrylib/Point2D.h"
+
+namespace GeometryLib {
+
+/**
+ * This class represents the exact value of a sum of doubles as a
+ * nonoverlapping expansion, i.e. a list of components ordered by
+ * increasing magnitude (J. R. Shewchuk, "Adaptive Precision
+ * Floating-Point Arithmetic and Fast Robust Geometric Predicates",
+ * 1997). The capacity is fixed, so using expansions never allocates
+ * memory.
+ */
+class Expansion {
+private:
+	static const int CAPACITY = 64;
+	double comp[CAPACITY];
+	int length;
+
+	static void twoSum (double a, double b, double& x, double& y) {
+		x = a + b;
+		double bv = x - a;
+		double av = x - bv;
+		y = (a - av) + (b - bv);
+	}
+
+	static void twoProduct (double a, double b, double& x, double& y) {
+		x = a * b;
+		y = std::fma(a, b, -x);
+	}
+
+public:
+	/**
+	 * Initialize a new expansion with the value zero.
+	 */
+	Expansion() : length(0) {
+	}
+
+	/**
+	 * Initialize a new expansion with the given value.
+	 *
+	 * @param value the value
+	 */
+	explicit Expansion(double value) : length(0) {
+		if (value != 0) {
+			comp[length++] = value;
+		}
+	}
+
+	/**
+	 * Return the exact difference of the given values.
+	 *
+	 * @param a the minuend
+	 * @param b the subtrahend
+	 * @return the difference
+	 */
+	static Expansion difference (double a, double b) {
+		Expansion res;
+		double x, y;
+		twoSum(a, -b, x, y);
+		if (y != 0) {
+			res.comp[res.length++] = y;
+		}
+		if (x != 0) {
+			res.comp[res.length++] = x;
+		}
+		return res;
+	}
+
+	/**
+	 * Add the given value to this expansion.
+	 *
+	 * @param value the value to add
+	 * @return this expansion
+	 */
+	Expansion& operator+= (double value) {
+		double q = value;
+		int n = 0;
+		for (int i = 0; i < length; i++) {
+			double h;
+			twoSum(q, comp[i], q, h);
+			if (h != 0) {
+				comp[n++] = h;
+			}
+		}
+		if (q != 0) {
+			comp[n++] = q;
+		}
+		length = n;
+		return *this;
+	}
+
+	/**
+	 * Add the given expansion to this expansion.
+	 *
+	 * @param other the expansion to add
+	 * @return this expansion
+	 */
+	Expansion& operator+= (const Expansion& other) {
+		for (int i = 0; i < other.length; i++) {
+			*this += other.comp[i];
+		}
+		return *this;
+	}
+
+	/**
+	 * Return the negated expansion.
+	 *
+	 * @return the result
+	 */
+	Expansion operator- () const {
+		Expansion res(*this);
+		for (int i = 0; i < length; i++) {
+			res.comp[i] = -comp[i];
+		}
+		return res;
+	}
+
+	/**
+	 * Multiply the expansion by the given value.
+	 *
+	 * @param factor the factor
+	 * @return the product
+	 */
+	Expansion operator* (double factor) const {
+		Expansion res;
+		for (int i = 0; i < length; i++) {
+			double x, y;
+			twoProduct(comp[i], factor, x, y);
+			res += y;
+			res += x;
+		}
+		return res;
+	}
+
+	/**
+	 * Multiply the expansion by the given expansion.
+	 *
+	 * @param other the factor
+	 * @return the product
+	 */
+	Expansion operator* (const Expansion& other) const {
+		Expansion res;
+		for (int i = 0; i < other.length; i++) {
+			res += *this * other.comp[i];
+		}
+		return res;
+	}
+
+	/**
+	 * Return an approximation of the expansion's value.
+	 *
+	 * @return the approximated value
+	 */
+	double estimate () const {
+		double sum = 0;
+		for (int i = 0; i < length; i++) {
+			sum += comp[i];
+		}
+		return sum;
+	}
+
+	/**
+	 * Return the sign of the expansion's value.
+	 *
+	 * @return -1, 0 or 1
+	 */
+	int sign () const {
+		if (length == 0) {
+			return 0;
+		}
+		return comp[length - 1] > 0 ? 1 : -1;
+	}
+};
+
+/**
+ * Relative error bound for the floating point evaluation of
+ * a * b - c * d where some of the factors are themselves rounded
+ * differences or sums. Results smaller than this bound times
+ * |a * b| + |c * d| are recomputed exactly.
+ */
+const double CROSS_ERROR_BOUND = 1e-15;
+
+/**
+ * Return the sign of the cross product (b - a) x (c - a), i.e. 1 if
+ * c is to the left of the directed line from a to b, -1 if it is to the
+ * right and 0 if the three points are collinear. The result is exact.
+ * It is computed using floating point arithmetic unless the result is
+ * too close to zero, in which case the expression is evaluated
+ * exactly.
+ *
+ * @param a the first point of the line
+ * @param b the second point of the line
+ * @param c the point to test
+ * @return the orientation
+ */
+template <class T>
+int orientation (const Point2D<T>& a, const Point2D<T>& b,
+				 const Point2D<T>& c) {
+	double ax = a.x(), ay = a.y();
+	double left = (double(b.x()) - ax) * (double(c.y()) - ay);
+	double right = (double(b.y()) - ay) * (double(c.x()) - ax);
+	double det = left - right;
+	if (std::abs(det) > CROSS_ERROR_BOUND * (std::abs(left) + std::abs(right))) {
+		return det > 0 ? 1 : -1;
+	}
+	Expansion exact = Expansion::difference(b.x(), ax)
+		* Expansion::difference(c.y(), ay);
+	exact += -(Expansion::difference(b.y(), ay)
+			   * Expansion::difference(c.x(), ax));
+	return exact.sign();
+}
+
+/**
+ * Return the sign of the cross product d x (p - o) where d is given
+ * as a vector, i.e. the side of the line through o with direction d
+ * that p lies on. See #orientation for the evaluation.
+ *
+ * @param ox x-coordinate of a point on the line
+ * @param oy y-coordinate of a point on the line
+ * @param dx x-component of the line's direction
+ * @param dy y-component of the line's direction
+ * @param px x-coordinate of the point to test
+ * @param py y-coordinate of the point to test
+ * @return the side
+ */
+inline int side (double ox, double oy, double dx, double dy,
+				 double px, double py) {
+	double left = dx * (py - oy);
+	double right = dy * (px - ox);
+	double det = left - right;
+	if (std::abs(det) > CROSS_ERROR_BOUND * (std::abs(left) + std::abs(right))) {
+		return det > 0 ? 1 : -1;
+	}
+	Expansion exact = Expansion::difference(py, oy) * dx;
+	exact += -(Expansion::difference(px, ox) * dy);
+	return exact.sign();
+}
+
+/**
+ * Return the orientation of three points with fixed-point coordinates
+ * (see above). The cross product's terms are evaluated exactly using
+ * 64 bit integers, which is possible as long as the coordinate
+ * differences stay within the range of Fixed.
+ */
+inline int orientation (const Point2D<Fixed>& a, const Point2D<Fixed>& b,
+						const Point2D<Fixed>& c) {
+	int64_t left = (int64_t(b.x().raw()) - a.x().raw())
+		* (int64_t(c.y().raw()) - a.y().raw());
+	int64_t right = (int64_t(b.y().raw()) - a.y().raw())
+		* (int64_t(c.x().raw()) - a.x().raw());
+	return left > right ? 1 : left < right ? -1 : 0;
+}
+
+/**
+ * Return the side of the line that a point lies on for fixed-point
+ * coordinates (see above). The result is exact.
+ */
+inline int side (Fixed ox, Fixed oy, Fixed dx, Fixed dy, Fixed px, Fixed py) {
+	int64_t left = int64_t(dx.raw()) * (int64_t(py.raw()) - oy.raw());
+	int64_t right = int64_t(dy.raw()) * (int64_t(px.raw()) - ox.raw());
+	return left > right ? 1 : left < right ? -1 : 0;
+}
+
+}
+
+#endif /* PREDICATES_H_ */
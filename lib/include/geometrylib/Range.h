@@ -0,0 +1,179 @@
+/*
+ * @file Range.h
+ * @date 17.10.2026
+ * @author ben
+ */
+
+#ifndef RANGE_H_
+#define RANGE_H_
+
+#include <cstddef>
+#include <iterator>
+
+namespace GeometryLib {
+
+/**
+ * This class is a non-owning view of a sequence of elements, defined
+ * by a pair of iterators. It allows objects to expose their parts
+ * without copying them and without exposing the container that holds
+ * them. A range can be used in a range-based for loop.
+ *
+ * A range is only valid as long as the object that provided it
+ * is neither modified nor destroyed.
+ */
+template <class Iterator>
+class Range {
+private:
+	Iterator first;
+	Iterator last;
+
+public:
+	typedef Iterator iterator;
+	typedef Iterator const_iterator;
+
+	/**
+	 * Initialize a new range from first (inclusive) to last (exclusive).
+	 *
+	 * @param first the iterator pointing to the first element
+	 * @param last the iterator pointing behind the last element
+	 */
+	Range(Iterator first, Iterator last) : first(first), last(last) {
+	}
+
+	/**
+	 * Return the iterator pointing to the first element.
+	 *
+	 * @return the iterator
+	 */
+	Iterator begin() const {
+		return first;
+	}
+
+	/**
+	 * Return the iterator pointing behind the last element.
+	 *
+	 * @return the iterator
+	 */
+	Iterator end() const {
+		return last;
+	}
+
+	/**
+	 * Return true if the range has no elements.
+	 *
+	 * @return the result
+	 */
+	bool empty() const {
+		return first == last;
+	}
+
+	/**
+	 * Return the number of elements in the range. This takes linear
+	 * time unless the iterators are random access iterators.
+	 *
+	 * @return the number of elements
+	 */
+	size_t size() const {
+		return std::distance(first, last);
+	}
+};
+
+/**
+ * This class is a forward iterator over the elements of a container
+ * that provides access by index (operator[]) and returns its elements
+ * as values, typically lightweight references into its storage. As
+ * the elements are values, operator-> returns a proxy holding the
+ * element.
+ */
+template <class Container, class Value>
+class IndexIterator {
+private:
+	const Container* container;
+	size_t index;
+
+public:
+	/**
+	 * The result of operator->.
+	 */
+	class Pointer {
+	private:
+		Value value;
+
+	public:
+		Pointer(const Value& value) : value(value) {
+		}
+
+		const Value* operator->() const {
+			return &value;
+		}
+	};
+
+	typedef std::forward_iterator_tag iterator_category;
+	typedef Value value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef Pointer pointer;
+	typedef Value reference;
+
+	/**
+	 * Initialize a new iterator that points to the element with the
+	 * given index.
+	 *
+	 * @param container the container
+	 * @param index the index
+	 */
+	IndexIterator(const Container* container, size_t index)
+		: container(container), index(index) {
+	}
+
+	/**
+	 * Return the element that the iterator points to.
+	 *
+	 * @return the element
+	 */
+	Value operator*() const {
+		return (*container)[index];
+	}
+
+	/**
+	 * Provide access to the members of the element that the
+	 * iterator points to.
+	 *
+	 * @return the proxy
+	 */
+	Pointer operator->() const {
+		return Pointer((*container)[index]);
+	}
+
+	/**
+	 * Advance to the next element.
+	 *
+	 * @return the iterator
+	 */
+	IndexIterator& operator++() {
+		index += 1;
+		return *this;
+	}
+
+	/**
+	 * Advance to the next element.
+	 *
+	 * @return the iterator before advancing
+	 */
+	IndexIterator operator++(int) {
+		IndexIterator res = *this;
+		index += 1;
+		return res;
+	}
+
+	bool operator==(const IndexIterator& other) const {
+		return index == other.index && container == other.container;
+	}
+
+	bool operator!=(const IndexIterator& other) const {
+		return !(*this == other);
+	}
+};
+
+}
+
+#endif /* RANGE_H_ */
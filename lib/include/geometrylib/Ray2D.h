@@ -10,7 +10,9 @@
 #define RAY2D_H_
 
 #include <cmath>
+#include "geometrylib/Fixed.h"
 #include "geometrylib/Point2D.h"
+#include "geometrylib/Vector2D.h"
 
 namespace GeometryLib {
 
@@ -18,13 +20,18 @@ namespace GeometryLib {
  * This class defines a ray on a two dimensional plane
  * that starts at a given Point2D<T> and goes to infinity.
  *
+ * The ray stores its starting point and its direction as a unit
+ * vector. All computations use the data type T. Rays are trivially
+ * copyable values. As the constructors normalize
+ * the direction (using sqrt or cos and sin), only
+ * the accessors can be evaluated at compile time.
  */
 template <class T>
 class Ray2D {
 private:
 	Point2D<T> startPos;
-	Point2D<T> dirPos;
-	Ray2D() {
+	Point2D<T> unitDir;
+	constexpr Ray2D() {
 	}
 
 public:
@@ -35,12 +42,10 @@ public:
 	 * @param start the starting point
 	 * @param dir a point this ray goes though
 	 */
-	Ray2D(Point2D<T> start, Point2D<T> dir) {
-		startPos = start;
-		double dx = dir.x() - start.x();
-		double dy = dir.y() - start.y();
-		double length = sqrt(dx*dx + dy*dy);
-		dirPos = Point2D<T>(start.x() + dx/length, start.y() + dy/length);
+	Ray2D(Point2D<T> start, Point2D<T> dir) : startPos(start) {
+		Vector2D<T> vec(start, dir);
+		T length = vec.length();
+		unitDir = Point2D<T>(vec.dx()/length, vec.dy()/length);
 	}
 
 	/**
@@ -50,12 +55,8 @@ public:
 	 * @param start the starting point
 	 * @param angle the agle from the x-axis
 	 */
-	Ray2D(Point2D<T> start, double angle) : startPos(0, 0), dirPos(1, 0) {
-		startPos = start;
-		dirPos = Point2D<T>(start.x() + cos(angle), start.y() + sin(angle));
-	}
-
-	virtual ~Ray2D() {
+	Ray2D(Point2D<T> start, T angle)
+		: startPos(start), unitDir(cos(angle), sin(angle)) {
 	}
 
 	/**
@@ -64,14 +65,14 @@ public:
 	 *
 	 * @return the rotated vector
 	 */
-	Ray2D<T> rotate(double angle) const {
-		double xShifted = dirPos.x() - startPos.x();
-		double yShifted = dirPos.y() - startPos.y();
+	Ray2D<T> rotate(T angle) const {
+		T cosine = cos(angle);
+		T sine = sin(angle);
 		Ray2D<T> res;
 		res.startPos = startPos;
-		res.dirPos = Point2D<T>
-			(startPos.x() + xShifted * cos(angle) - yShifted * sin(angle),
-		     startPos.y() + xShifted * sin(angle) + yShifted * cos(angle));
+		res.unitDir = Point2D<T>
+			(unitDir.x() * cosine - unitDir.y() * sine,
+		     unitDir.x() * sine + unitDir.y() * cosine);
 		return res;
 	}
 
@@ -80,19 +81,28 @@ public:
 	 *
 	 * @return the starting point
 	 */
-	Point2D<T> start() const {
+	constexpr Point2D<T> start() const {
 		return startPos;
 	}
 
+	/**
+	 * Return the ray's direction as a vector of length one.
+	 *
+	 * @return the direction
+	 */
+	constexpr Vector2D<T> direction() const {
+		return Vector2D<T>(Point2D<T>(0, 0), unitDir);
+	}
+
 	/**
 	 * Return the point on the ray that has the given distance
 	 * from the starting point.
 	 *
 	 * @param dist the distance from the starting point
 	 */
-	Point2D<T> point(double dist) const {
-		return Point2D<T>(startPos.x() + dist * (dirPos.x() - startPos.x()),
-						  startPos.y() + dist * (dirPos.y() - startPos.y()));
+	constexpr Point2D<T> point(T dist) const {
+		return Point2D<T>(startPos.x() + dist * unitDir.x(),
+						  startPos.y() + dist * unitDir.y());
 	}
 
 };
@@ -10,13 +10,19 @@
 #define SEGMENT2D_H_
 
 #include <cmath>
+#include <limits>
+#include <type_traits>
+#include "geometrylib/Fixed.h"
 #include "geometrylib/Point2D.h"
+#include "geometrylib/Ray2D.h"
+#include "geometrylib/Predicates.h"
 
 namespace GeometryLib {
 
 /**
  * This class describes a directed line between two points
- * in the two dimensional space.
+ * in the two dimensional space. Segments are trivially copyable values
+ * that can be constructed at compile time.
  */
 template <class T>
 class Segment2D {
@@ -25,42 +31,31 @@ private:
 	Point2D<T> endPos;
 
 	/**
-	 * Find the intersection between this line and the given line,
-	 * assuming endless lines.
+	 * Compute the point start + t * (end - start) where t is given
+	 * as the quotient of the cross products (p - start) x dir and
+	 * (end - start) x dir. The caller must have established that
+	 * the lines are not parallel.
 	 *
-	 * @param res the intersection point
-	 * @param other the other line
-	 * @return true if the lines intersect
+	 * @param p a point on the other line
+	 * @param dx x-component of the other line's direction
+	 * @param dy y-component of the other line's direction
+	 * @return the intersection point
 	 */
-	bool intersectionPoint (Point2D<T>& res, Segment2D<T> other) const {
-		// Taken and adapted from
-		// http://workshop.evolutionzone.com/2007/09/10/code-2d-line-intersection/
-
-		// calculate differences
-		Vector2D<T> v1(startPos, endPos);
-		Vector2D<T> v2(other.startPos, other.endPos);
-
-		// calculate the lengths of the two lines
-		T len1=v1.length();
-		T len2=v2.length();
-
-		// calculate cosine of angle between the two lines.
-		double ca=v1*v2/(len1 * len2);
-
-		// if abs(angle)==1 then the lines are parallell,
-		// so no intersection is possible
-		if(std::abs(ca)==1) {
-			return false;
+	Point2D<T> pointAt (const Point2D<T>& p, T dx, T dy) const {
+		T ex = endPos.x() - startPos.x();
+		T ey = endPos.y() - startPos.y();
+		T t;
+		if constexpr (std::is_same<T, Fixed>::value) {
+			// Products of coordinates may exceed the range of Fixed
+			t = Fixed::quotient(
+				int64_t((p.x() - startPos.x()).raw()) * dy.raw()
+					- int64_t((p.y() - startPos.y()).raw()) * dx.raw(),
+				int64_t(ex.raw()) * dy.raw() - int64_t(ey.raw()) * dx.raw());
+		} else {
+			t = ((p.x() - startPos.x()) * dy - (p.y() - startPos.y()) * dx)
+				/ (ex * dy - ey * dx);
 		}
-
-		// find intersection Pt between two lines
-		Vector2D<T> v3(other.startPos, startPos);
-		T div=v2.dy()*v1.dx()-v2.dx()*v1.dy();
-		T ua=(v2.dx()*v3.dy()-v2.dy()*v3.dx())/div;
-		res = startPos + v1 * ua;
-
-		// return the valid intersection
-		return true;
+		return Point2D<T>(startPos.x() + t * ex, startPos.y() + t * ey);
 	}
 
 public:
@@ -70,19 +65,16 @@ public:
 	 * @param start the start point
 	 * @param end the end point
 	 */
-	Segment2D(Point2D<T> start, Point2D<T> end)
+	constexpr Segment2D(Point2D<T> start, Point2D<T> end)
 		: startPos(start), endPos (end) {
 	}
 
-	virtual ~Segment2D() {
-	}
-
 	/**
 	 * Return the start point of this segment.
 	 *
 	 * @return the start point
 	 */
-	Point2D<T> start() const {
+	constexpr Point2D<T> start() const {
 		return startPos;
 	}
 
@@ -91,7 +83,7 @@ public:
 	 *
 	 * @return the end point
 	 */
-	Point2D<T> end() const {
+	constexpr Point2D<T> end() const {
 		return endPos;
 	}
 
@@ -100,8 +92,8 @@ public:
 	 *
 	 * @return the length
 	 */
-	double length() const {
-		return sqrt(squaredLength());
+	T length() const {
+		return Vector2D<T>(startPos, endPos).length();
 	}
 
 	/**
@@ -109,71 +101,125 @@ public:
 	 *
 	 * @return the square of the length
 	 */
-	double squaredLength() const {
-		double dx = endPos.x() - startPos.x();
-		double dy = endPos.y() - startPos.y();
+	constexpr T squaredLength() const {
+		T dx = endPos.x() - startPos.x();
+		T dy = endPos.y() - startPos.y();
 		return dx*dx + dy*dy;
 	}
 
 	/**
 	 * Find the intersection between this line and the given line, if any.
 	 *
+	 * The decision is based on the orientation of each segment's end
+	 * points relative to the other segment (see GeometryLib#orientation)
+	 * and is therefore exact. Collinear segments are not considered
+	 * to intersect. For types with exact arithmetic (Fixed), the
+	 * floating point fast path is skipped.
+	 *
 	 * @param res the intersection point
 	 * @param other the other line
 	 * @return true if the lines intersect
 	 */
-	bool findIntersection (Point2D<T>& res, Segment2D<T> other) const {
-		intersectionPoint(res, other);
-
-		// if the lengths of the sets of segments is not the same as
-		// the lengths of the line the point is actually
-		// not on the line segment.
-
-		// calculate the combined lengths of the two segments
-		// between Pt-p1 and Pt-p2
-		T segmentLen1 = Vector2D<T>(startPos, res).length()
-					    + Vector2D<T>(res, endPos).length();
-		if (abs(Vector2D<T>(startPos, endPos).length()-segmentLen1) > 0.001) {
-			return false;
+	bool findIntersection (Point2D<T>& res, const Segment2D<T>& other) const {
+		bool hit = false;
+		bool decided = false;
+		if constexpr (!std::numeric_limits<T>::is_exact) {
+			double ex = double(endPos.x()) - startPos.x();
+			double ey = double(endPos.y()) - startPos.y();
+			double fx = double(other.endPos.x()) - other.startPos.x();
+			double fy = double(other.endPos.y()) - other.startPos.y();
+			double wx = double(other.startPos.x()) - startPos.x();
+			double wy = double(other.startPos.y()) - startPos.y();
+			double vx = double(other.endPos.x()) - startPos.x();
+			double vy = double(other.endPos.y()) - startPos.y();
+			double ux = double(endPos.x()) - other.startPos.x();
+			double uy = double(endPos.y()) - other.startPos.y();
+			// Fast path: orientations of each segment's end points relative
+			// to the other segment in floating point
+			double a1 = ex * wy, a2 = ey * wx, o1 = a1 - a2;
+			double b1 = ex * vy, b2 = ey * vx, o2 = b1 - b2;
+			double c1 = fx * wy, c2 = fy * wx, o3 = c2 - c1;
+			double d1 = fx * uy, d2 = fy * ux, o4 = d1 - d2;
+			if ((std::abs(o1) > CROSS_ERROR_BOUND * (std::abs(a1) + std::abs(a2)))
+				& (std::abs(o2) > CROSS_ERROR_BOUND * (std::abs(b1) + std::abs(b2)))
+				& (std::abs(o3) > CROSS_ERROR_BOUND * (std::abs(c1) + std::abs(c2)))
+				& (std::abs(o4) > CROSS_ERROR_BOUND * (std::abs(d1) + std::abs(d2)))) {
+				hit = ((o1 < 0) != (o2 < 0)) & ((o3 < 0) != (o4 < 0));
+				decided = true;
+			}
 		}
-
-		// calculate the combined lengths of the two segments
-		// between Pt-p3 and Pt-p4
-		T segmentLen2 = Vector2D<T>(other.startPos, res).length()
-					    + Vector2D<T>(res, other.endPos).length();
-
-		return abs(Vector2D<T>(other.startPos, other.endPos).length()
-				   -segmentLen2) < 0.001;
+		if (!decided) {
+			int s1 = orientation(startPos, endPos, other.startPos);
+			int s2 = orientation(startPos, endPos, other.endPos);
+			int s3 = orientation(other.startPos, other.endPos, startPos);
+			int s4 = orientation(other.startPos, other.endPos, endPos);
+			hit = s1 * s2 <= 0 && s3 * s4 <= 0 && (s1 != 0 || s2 != 0);
+		}
+		if (hit) {
+			res = pointAt(other.startPos, other.endPos.x() - other.startPos.x(),
+						  other.endPos.y() - other.startPos.y());
+		}
+		return hit;
 	}
 
 	/**
 	 * Find the intersection between this line and the given ray, if any.
 	 *
+	 * The segment is hit if its end points are on different sides of
+	 * (or on) the ray's line and the segment's line does not pass
+	 * behind the ray's starting point. Both decisions are made using
+	 * exact orientation tests (see GeometryLib#orientation), so no
+	 * tolerances are involved. A segment that is collinear with the
+	 * ray is not considered to intersect. For types with exact
+	 * arithmetic (Fixed), the floating point fast path is skipped.
+	 *
 	 * @param res the intersection point
 	 * @param ray the ray
 	 * @return true if the line and the ray intersect
 	 */
-	bool findIntersection (Point2D<T>& res, Ray2D<T> ray) const {
-		intersectionPoint(res, Segment2D<T>(ray.start(), ray.point(1)));
-
-		// calculate the combined lengths of the two segments
-		// between Pt-p1 and Pt-p2
-		T segmentLen1 = Vector2D<T>(startPos, res).length()
-					    + Vector2D<T>(res, endPos).length();
-
-		// if the length of the combined segments istn't the length
-		// of the line, the point is not on the line
-		if(std::abs(Vector2D<T>(startPos, endPos).length()-segmentLen1) > 0.001) {
-			return false;
+	bool findIntersection (Point2D<T>& res, const Ray2D<T>& ray) const {
+		Point2D<T> origin = ray.start();
+		T dx = ray.direction().dx();
+		T dy = ray.direction().dy();
+		bool hit = false;
+		bool decided = false;
+		if constexpr (!std::numeric_limits<T>::is_exact) {
+			double wax = double(startPos.x()) - origin.x();
+			double way = double(startPos.y()) - origin.y();
+			double wbx = double(endPos.x()) - origin.x();
+			double wby = double(endPos.y()) - origin.y();
+			// Fast path: the three cross products in floating point
+			double a1 = dx * way, a2 = dy * wax, sa = a1 - a2;
+			double b1 = dx * wby, b2 = dy * wbx, sb = b1 - b2;
+			double c1 = wax * wby, c2 = way * wbx, sc = c1 - c2;
+			if ((std::abs(sa) > CROSS_ERROR_BOUND * (std::abs(a1) + std::abs(a2)))
+				& (std::abs(sb) > CROSS_ERROR_BOUND * (std::abs(b1) + std::abs(b2)))
+				& (std::abs(sc) > CROSS_ERROR_BOUND * (std::abs(c1) + std::abs(c2)))) {
+				// None is zero, so the end points are strictly on different
+				// sides and direction x (end - start) = sb - sa
+				// must have the same sign as sc.
+				hit = ((sa < 0) != (sb < 0)) & ((sc > 0) == (sa < 0));
+				decided = true;
+			}
 		}
-
-		// If a vector from ray's start to the intersection doesn't have
-		// the same direction as the ray, the point is not on the ray.
-		Vector2D<T> toRes = Vector2D<T>(ray.start(), res).scale(1);
-		Vector2D<T> rayDir(ray.start(), ray.point(1));
-
-		return std::abs(toRes.dx() - rayDir.dx()) < 0.001
-			   && std::abs(toRes.dy() - rayDir.dy()) < 0.001;
+		if (!decided) {
+			int oa = side(origin.x(), origin.y(), dx, dy,
+						  startPos.x(), startPos.y());
+			int ob = side(origin.x(), origin.y(), dx, dy,
+						  endPos.x(), endPos.y());
+			int oc = orientation(origin, startPos, endPos);
+			int denom = oa <= 0 && ob >= 0 ? 1 : -1;
+			hit = oa * ob <= 0 && (oa != 0 || ob != 0)
+				&& (oc == 0 || oc == denom);
+			if (hit && oc == 0) {
+				res = origin;
+				return true;
+			}
+		}
+		if (hit) {
+			res = pointAt(origin, dx, dy);
+		}
+		return hit;
 	}
 
 };
@@ -10,13 +10,17 @@
 #define VECTOR2D_H_
 
 #include <cmath>
+#include <limits>
+#include "geometrylib/Fixed.h"
 #include "geometrylib/Point2D.h"
 
 namespace GeometryLib {
 
 /**
  * This class describes a vector in the two dimensional space. A vector
- * denotes the difference between two Points2D<T>.
+ * denotes the difference between two Points2D<T>. All computations
+ * use the data type T. Like points, vectors
+ * are trivially copyable values that can be constructed at compile time.
  */
 template <class T>
 class Vector2D {
@@ -28,19 +32,16 @@ public:
 	 * Create a new vector that denotes the difference between the
 	 * given points.
 	 */
-	Vector2D(Point2D<T> start, Point2D<T> end)
+	constexpr Vector2D(Point2D<T> start, Point2D<T> end)
 		: endPos (end.x() - start.x(), end.y() - start.y()) {
 	}
 
-	virtual ~Vector2D() {
-	}
-
 	/**
 	 * Return the difference on the x-axis denoted by this vector.
 	 *
 	 * @return the difference
 	 */
-	double dx() const {
+	constexpr T dx() const {
 		return endPos.x();
 	}
 
@@ -49,7 +50,7 @@ public:
 	 *
 	 * @return the difference
 	 */
-	double dy() const {
+	constexpr T dy() const {
 		return endPos.y();
 	}
 
@@ -58,9 +59,9 @@ public:
 	 *
 	 * @return the square of the length
 	 */
-	double squaredLength() const {
-		double dx = endPos.x();
-		double dy = endPos.y();
+	constexpr T squaredLength() const {
+		T dx = endPos.x();
+		T dy = endPos.y();
 		return dx*dx + dy*dy;
 	}
 
@@ -69,8 +70,13 @@ public:
 	 *
 	 * @return the length
 	 */
-	double length() const {
-		return sqrt(squaredLength());
+	T length() const {
+		if constexpr (std::numeric_limits<T>::is_exact) {
+			// The square may exceed the range of fixed-point numbers
+			return hypot(endPos.x(), endPos.y());
+		} else {
+			return sqrt(squaredLength());
+		}
 	}
 
 	/**
@@ -79,10 +85,12 @@ public:
 	 * @param angle the angle
 	 * @return the rotated vector
 	 */
-	Vector2D<T> rotate(double angle) const {
+	Vector2D<T> rotate(T angle) const {
+		T cosine = cos(angle);
+		T sine = sin(angle);
 		return Vector2D<T>(Point2D<T>(0, 0), Point2D<T>
-			(endPos.x() * std::cos(angle) - endPos.y() * std::sin(angle),
-		     endPos.x() * std::sin(angle) + endPos.y() * std::cos(angle)));
+			(endPos.x() * cosine - endPos.y() * sine,
+		     endPos.x() * sine + endPos.y() * cosine));
 	}
 
 	/**
@@ -91,7 +99,7 @@ public:
 	 * @param vec the vecor to add
 	 * @return the result
 	 */
-	Vector2D<T> operator+ (const Vector2D<T>& vec) const {
+	constexpr Vector2D<T> operator+ (const Vector2D<T>& vec) const {
 		return Vector2D<T>(Point2D<T>(0,0), Point2D<T>
 			(endPos.x() + vec.dx(),
 			 endPos.y() + vec.dy()));
@@ -103,10 +111,10 @@ public:
 	 * @param length the length of the new vector
 	 * @return the scaled vector
 	 */
-	Vector2D<T> scale(double length) const {
-		double scale = length / this->length();
+	Vector2D<T> scale(T length) const {
+		T current = this->length();
 		return Vector2D<T>(Point2D<T>(0,0), Point2D<T>
-			(scale * endPos.x(), scale * endPos.y()));
+			(endPos.x() / current * length, endPos.y() / current * length));
 	}
 
 	/**
@@ -114,7 +122,7 @@ public:
 	 *
 	 * @return the scalar product
 	 */
-	double operator* (const Vector2D<T>& vec) const  {
+	constexpr T operator* (const Vector2D<T>& vec) const  {
 		return endPos.x() * vec.endPos.x()
 			   + endPos.y() * vec.endPos.y();
 	}
@@ -124,7 +132,7 @@ public:
 	 *
 	 * @return the result
 	 */
-	Vector2D<T> operator* (T factor) const  {
+	constexpr Vector2D<T> operator* (T factor) const  {
 		return Vector2D<T>(Point2D<T>(0,0), Point2D<T>
 			(factor * endPos.x(), factor * endPos.y()));
 	}
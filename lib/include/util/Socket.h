@@ -42,6 +42,7 @@ typedef int SOCKET;
 #endif
 
 #include <string>
+#include <atomic>
 
 enum TypeSocket {BlockingSocket, NonBlockingSocket};
 
@@ -55,6 +56,10 @@ public:
   std::string ReceiveLine();
   std::string ReceiveBytes();
 
+  // Receives exactly length bytes (blocking), returns false if the
+  // connection is closed before.
+  bool   ReceiveExactly(char* data, size_t length);
+
   void   Close();
 
   // The parameter of SendLine is not a const reference
@@ -65,10 +70,12 @@ public:
   // because SendBytes does not modify the std::string passed
   // (in contrast to SendLine).
   int    SendBytes(const std::string&);
+  int    SendBytes(const char* data, size_t length);
 
 protected:
   friend class SocketServer;
   friend class SocketSelect;
+  friend class SocketReactor;
 
   Socket(SOCKET s);
   Socket();
@@ -76,12 +83,27 @@ protected:
 
   SOCKET s_;
 
-  int* refCounter_;
+  // Shared by all copies, may be copied and destroyed in different threads
+  std::atomic<int>* refCounter_;
 
 private:
+  // Received data not yet returned by ReceiveLine or ReceiveBytes.
+  // Shared by all copies (like the connection itself), refilled with
+  // one recv of up to sizeof(data) bytes.
+  struct ReadBuffer {
+    char   data[4096];
+    size_t begin;
+    size_t end;
+  };
+  ReadBuffer* buffer_;
+
+  void   Init();
+  void   Release();
+  void   TakeBuffered(std::string&);
+
   static void Start();
   static void End();
-  static int  nofSockets_;
+  static std::atomic<int> nofSockets_;
 };
 
 class SocketClient : public Socket {
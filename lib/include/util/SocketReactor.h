@@ -0,0 +1,168 @@
+/*
+   SocketReactor.h
+
+   Author: ben
+
+   Event loop for many connections on one thread, based on Linux epoll.
+   Builds on the Socket classes (see Socket.h).
+*/
+
+#ifndef SOCKETREACTOR_H
+#define SOCKETREACTOR_H
+
+#ifdef __linux__
+
+#include "util/Socket.h"
+#include <string>
+#include <map>
+#include <set>
+#include <memory>
+#include <chrono>
+#include <functional>
+
+class SocketReactor;
+
+// A connection handled by a SocketReactor. All sockets are non-blocking,
+// received data is collected in Input(), data passed to Send is buffered
+// until the socket accepts it.
+class ReactorConnection {
+public:
+  ~ReactorConnection();
+
+  // Unique (never reused) id of the connection, see SocketReactor::Find
+  int Id() const;
+
+  // Received data not yet consumed. The handler removes what it has
+  // processed (e.g. with erase).
+  std::string& Input();
+
+  // Sends the data or, if the socket does not accept it now, keeps
+  // it in the output buffer until it does.
+  void Send(const char* data, size_t length);
+  void Send(const std::string& data);
+
+  // Number of bytes waiting in the output buffer.
+  size_t Pending() const;
+
+  // Closes the connection after the output buffer has been sent.
+  void Close();
+
+  bool Closing() const;
+
+private:
+  friend class SocketReactor;
+
+  ReactorConnection(SocketReactor& reactor, SOCKET s, int id);
+
+  bool Flush();
+
+  SocketReactor& reactor_;
+  SOCKET s_;
+  int id_;
+  std::string input_;
+  std::string output_;
+  // Start of the data in output_ not yet sent
+  size_t outputStart_;
+  bool closing_;
+  bool failed_;
+  // The peer has finished sending
+  bool ended_;
+};
+
+// The application's callbacks. All callbacks run on the thread
+// that calls SocketReactor::Run or RunOnce.
+class ReactorHandler {
+public:
+  virtual ~ReactorHandler();
+
+  // A connection has been accepted from a server added with Listen.
+  virtual void OnConnect(ReactorConnection&);
+
+  // New data has been appended to the connection's input.
+  virtual void OnData(ReactorConnection&) = 0;
+
+  // The peer has finished sending (end of file, e.g. after
+  // shutdown(SHUT_WR)), all data sent before has been passed to
+  // OnData. The connection can still be used for sending. The default
+  // implementation calls Close, which closes the connection after the
+  // output buffer has been sent.
+  virtual void OnEnd(ReactorConnection&);
+
+  // The connection is closed (by the peer, because of an error or
+  // after Close). It is removed when the callback returns.
+  virtual void OnClose(ReactorConnection&);
+};
+
+// Edge-triggered epoll event loop. Accepts connections on any number
+// of listening sockets, reads and writes all connections without
+// blocking and runs timers. Not thread-safe: all methods must be called
+// from the thread that runs the loop (or before it is started).
+class SocketReactor {
+public:
+  typedef std::chrono::steady_clock Clock;
+
+  SocketReactor(ReactorHandler& handler);
+  ~SocketReactor();
+
+  // Accepts connections on the server's socket, which is switched to
+  // non-blocking mode. The server must outlive the reactor.
+  void Listen(SocketServer& server);
+
+  // Handles an already connected socket (e.g. to an upstream server).
+  // The reactor takes over the connection, the Socket object may be
+  // destroyed afterwards.
+  ReactorConnection& Add(Socket& socket);
+
+  // Returns the connection with the given id or NULL if it is closed.
+  ReactorConnection* Find(int id);
+
+  size_t Connections() const;
+
+  // Calls callback after the given delay and, if repeat is true,
+  // with that interval afterwards until cancelled. Returns the id of
+  // the timer.
+  int AddTimer(double seconds, const std::function<void()>& callback,
+               bool repeat=false);
+  void CancelTimer(int id);
+
+  // Waits at most timeoutMs milliseconds (-1: until something happens)
+  // for events and handles them together with the expired timers.
+  void RunOnce(int timeoutMs=-1);
+
+  // Handles events until Stop is called.
+  void Run();
+  void Stop();
+
+private:
+  friend class ReactorConnection;
+
+  struct Timer {
+    Clock::duration interval;
+    bool repeat;
+    std::function<void()> callback;
+  };
+
+  void Register(SOCKET s, bool listening);
+  void AcceptAll(SOCKET listener);
+  void ReadAll(ReactorConnection& con);
+  void Remove(ReactorConnection& con);
+  void RunTimers();
+  int TimeoutMs(int timeoutMs) const;
+
+  ReactorHandler& handler_;
+  int epoll_;
+  bool stopped_;
+  int nextId_;
+  std::set<SOCKET> listeners_;
+  std::map<SOCKET, std::unique_ptr<ReactorConnection> > byHandle_;
+  std::map<int, ReactorConnection*> byId_;
+  // Closed during an iteration, removed at its end
+  std::set<ReactorConnection*> closed_;
+  std::map<int, Timer> timers_;
+  std::set<std::pair<Clock::time_point, int> > due_;
+  int nextTimer_;
+};
+
+#endif
+
+#endif
@@ -29,8 +29,10 @@
 
 #include "util/Socket.h"
 #include <iostream>
+#include <cstring>
 #if ((defined WIN32) || (defined __CYGWIN32__) || (defined __CYGWIN__))
 // --- this is for MS Windows ---
+#include <ws2tcpip.h>
 typedef int socklen_t;
 #else
 // --- this is for Linux ---
@@ -47,19 +49,18 @@ typedef struct timeval TIMEVAL;
 
 using namespace std;
 
-int Socket::nofSockets_= 0;
+std::atomic<int> Socket::nofSockets_(0);
 
 void Socket::Start() {
+  if (nofSockets_++ == 0) {
 #if ((defined WIN32) || (defined __CYGWIN32__) || (defined __CYGWIN__))
-  // --- this is for MS Windows ---
-  if (!nofSockets_) {
+    // --- this is for MS Windows ---
     WSADATA info;
     if (WSAStartup(MAKEWORD(2,0), &info)) {
       throw "Could not start WSA";
     }
-  }
 #endif
-  ++nofSockets_;
+  }
 }
 
 void Socket::End() {
@@ -78,27 +79,39 @@ Socket::Socket() : s_(0) {
     throw "INVALID_SOCKET";
   }
 
-  refCounter_ = new int(1);
+  Init();
 }
 
 Socket::Socket(SOCKET s) : s_(s) {
   Start();
-  refCounter_ = new int(1);
+  Init();
 }
 
-Socket::~Socket() {
+void Socket::Init() {
+  refCounter_ = new std::atomic<int>(1);
+  buffer_ = new ReadBuffer;
+  buffer_->begin = 0;
+  buffer_->end = 0;
+}
+
+void Socket::Release() {
   if (! --(*refCounter_)) {
     Close();
     delete refCounter_;
+    delete buffer_;
   }
+}
 
-  --nofSockets_;
-  if (!nofSockets_) End();
+Socket::~Socket() {
+  Release();
+
+  if (! --nofSockets_) End();
 }
 
 Socket::Socket(const Socket& o) {
   refCounter_=o.refCounter_;
   (*refCounter_)++;
+  buffer_    =o.buffer_;
   s_         =o.s_;
 
   nofSockets_++;
@@ -107,11 +120,14 @@ Socket::Socket(const Socket& o) {
 Socket& Socket::operator=(Socket& o) {
   (*o.refCounter_)++;
 
+  // Release the socket previously referred to (the number of
+  // Socket objects does not change)
+  Release();
+
   refCounter_=o.refCounter_;
+  buffer_    =o.buffer_;
   s_         =o.s_;
 
-  nofSockets_++;
-
   return *this;
 }
 
@@ -124,11 +140,22 @@ void Socket::Close() {
 #endif
 }
 
+// Move all buffered data to the end of ret.
+void Socket::TakeBuffered(std::string& ret) {
+  ret.append(buffer_->data + buffer_->begin, buffer_->end - buffer_->begin);
+  buffer_->begin = 0;
+  buffer_->end = 0;
+}
+
 std::string Socket::ReceiveBytes() {
   std::string ret;
-  char buf[1024];
+  TakeBuffered(ret);
 
   while (1) {
+#ifdef MSG_DONTWAIT
+    // One call per chunk, stops when nothing is left
+    int rv = recv (s_, buffer_->data, sizeof(buffer_->data), MSG_DONTWAIT);
+#else
     u_long arg = 0;
 #if ((defined WIN32) || (defined __CYGWIN32__) || (defined __CYGWIN__))
   // --- this is for MS Windows ---
@@ -141,15 +168,13 @@ std::string Socket::ReceiveBytes() {
     if (arg == 0)
       break;
 
-    if (arg > 1024) arg = 1024;
+    if (arg > sizeof(buffer_->data)) arg = sizeof(buffer_->data);
 
-    int rv = recv (s_, buf, arg, 0);
+    int rv = recv (s_, buffer_->data, arg, 0);
+#endif
     if (rv <= 0) break;
 
-    std::string t;
-
-    t.assign (buf, rv);
-    ret += t;
+    ret.append (buffer_->data, rv);
   }
 
   return ret;
@@ -158,9 +183,20 @@ std::string Socket::ReceiveBytes() {
 std::string Socket::ReceiveLine() {
   std::string ret;
   while (1) {
-    char r;
+    const char* start = buffer_->data + buffer_->begin;
+    size_t avail = buffer_->end - buffer_->begin;
+    const char* eol = (const char*) memchr(start, '\n', avail);
+    if (eol != NULL) {
+      size_t n = eol - start + 1;
+      ret.append(start, n);
+      buffer_->begin += n;
+      return ret;
+    }
+    TakeBuffered(ret);
 
-    switch(recv(s_, &r, 1, 0)) {
+    // Refill the buffer with as much as is available
+    int rv = recv(s_, buffer_->data, sizeof(buffer_->data), 0);
+    switch(rv) {
       case 0: // not connected anymore;
               // ... but last line sent
               // might not end in \n,
@@ -175,10 +211,26 @@ std::string Socket::ReceiveLine() {
 //      return "";
 //      }
     }
+    buffer_->end = rv;
+  }
+}
 
-    ret += r;
-    if (r == '\n')  return ret;
+bool Socket::ReceiveExactly(char* data, size_t length) {
+  while (length > 0) {
+    if (buffer_->begin == buffer_->end) {
+      int rv = recv(s_, buffer_->data, sizeof(buffer_->data), 0);
+      if (rv <= 0) return false;
+      buffer_->begin = 0;
+      buffer_->end = rv;
+    }
+    size_t n = buffer_->end - buffer_->begin;
+    if (n > length) n = length;
+    memcpy(data, buffer_->data + buffer_->begin, n);
+    buffer_->begin += n;
+    data += n;
+    length -= n;
   }
+  return true;
 }
 
 int Socket::SendLine(std::string s) {
@@ -190,6 +242,10 @@ int Socket::SendBytes(const std::string& s) {
   return send(s_,s.c_str(),s.length(),0);
 }
 
+int Socket::SendBytes(const char* data, size_t length) {
+  return send(s_,data,length,0);
+}
+
 SocketServer::SocketServer(int port, int connections, TypeSocket type) {
   sockaddr_in sa;
 
@@ -250,17 +306,22 @@ Socket* SocketServer::Accept() {
 SocketClient::SocketClient(const std::string& host, int port) : Socket() {
   std::string error;
 
-  hostent *he;
-  if ((he = gethostbyname(host.c_str())) == 0) {
-    error = strerror(errno);
+  // Unlike gethostbyname, getaddrinfo may be called from several
+  // threads at the same time
+  addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo *he;
+  int res = getaddrinfo(host.c_str(), NULL, &hints, &he);
+  if (res != 0) {
+    error = gai_strerror(res);
     throw error;
   }
 
-  sockaddr_in addr;
-  addr.sin_family = AF_INET;
+  sockaddr_in addr = *((sockaddr_in *)he->ai_addr);
+  freeaddrinfo(he);
   addr.sin_port = htons(port);
-  addr.sin_addr = *((in_addr *)he->h_addr);
-  memset(&(addr.sin_zero), 0, 8);
 
   if (::connect(s_, (sockaddr *) &addr, sizeof(sockaddr))) {
 #if ((defined WIN32) || (defined __CYGWIN32__) || (defined __CYGWIN__))
@@ -292,7 +353,12 @@ SocketSelect::SocketSelect(Socket const * const s1, Socket const * const s2, Typ
     ptval = 0;
   }
 
-  if (select (0, &fds_, (fd_set*) 0, (fd_set*) 0, ptval) == SOCKET_ERROR)
+  // nfds is ignored on Windows, but elsewhere it must be the highest
+  // descriptor plus one or no socket is watched at all
+  SOCKET max = s1->s_;
+  if (s2 && s2->s_ > max) max = s2->s_;
+
+  if (select (max + 1, &fds_, (fd_set*) 0, (fd_set*) 0, ptval) == SOCKET_ERROR)
     throw "Error in select";
 }
 
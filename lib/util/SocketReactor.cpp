@@ -0,0 +1,329 @@
+/*
+   SocketReactor.cpp
+
+   Author: ben
+*/
+
+#ifdef __linux__
+
+#include "util/SocketReactor.h"
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+using namespace std;
+
+namespace {
+
+  void SetNonBlocking(SOCKET s) {
+    int flags = fcntl(s, F_GETFL, 0);
+    fcntl(s, F_SETFL, flags | O_NONBLOCK);
+  }
+
+}
+
+// --- ReactorConnection ---
+
+ReactorConnection::ReactorConnection(SocketReactor& reactor, SOCKET s, int id)
+  : reactor_(reactor), s_(s), id_(id), outputStart_(0),
+    closing_(false), failed_(false), ended_(false) {
+}
+
+ReactorConnection::~ReactorConnection() {
+  close(s_);
+}
+
+int ReactorConnection::Id() const {
+  return id_;
+}
+
+std::string& ReactorConnection::Input() {
+  return input_;
+}
+
+size_t ReactorConnection::Pending() const {
+  return output_.size() - outputStart_;
+}
+
+bool ReactorConnection::Closing() const {
+  return closing_;
+}
+
+void ReactorConnection::Send(const std::string& data) {
+  Send(data.data(), data.size());
+}
+
+void ReactorConnection::Send(const char* data, size_t length) {
+  if (closing_ || failed_) return;
+  if (Pending() == 0) {
+    // Try to send directly, buffer only what is left
+    while (length > 0) {
+      ssize_t rv = send(s_, data, length, MSG_NOSIGNAL);
+      if (rv < 0) {
+        if (errno == EINTR) continue;
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+          failed_ = true;
+          reactor_.closed_.insert(this);
+          return;
+        }
+        break;
+      }
+      data += rv;
+      length -= rv;
+    }
+  }
+  output_.append(data, length);
+}
+
+void ReactorConnection::Close() {
+  closing_ = true;
+  if (Pending() == 0) {
+    reactor_.closed_.insert(this);
+  }
+}
+
+// Sends buffered output until the socket would block. Returns false
+// if the connection failed.
+bool ReactorConnection::Flush() {
+  while (Pending() > 0) {
+    ssize_t rv = send(s_, output_.data() + outputStart_, Pending(),
+                      MSG_NOSIGNAL);
+    if (rv < 0) {
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+      failed_ = true;
+      return false;
+    }
+    outputStart_ += rv;
+  }
+  // Everything sent, reuse the buffer
+  output_.clear();
+  outputStart_ = 0;
+  if (closing_) {
+    reactor_.closed_.insert(this);
+  }
+  return true;
+}
+
+// --- ReactorHandler ---
+
+ReactorHandler::~ReactorHandler() {
+}
+
+void ReactorHandler::OnConnect(ReactorConnection&) {
+}
+
+void ReactorHandler::OnEnd(ReactorConnection& con) {
+  con.Close();
+}
+
+void ReactorHandler::OnClose(ReactorConnection&) {
+}
+
+// --- SocketReactor ---
+
+SocketReactor::SocketReactor(ReactorHandler& handler)
+  : handler_(handler), stopped_(false), nextId_(1), nextTimer_(1) {
+  epoll_ = epoll_create1(0);
+  if (epoll_ < 0) {
+    throw "Could not create epoll instance";
+  }
+}
+
+SocketReactor::~SocketReactor() {
+  byId_.clear();
+  byHandle_.clear();
+  close(epoll_);
+}
+
+void SocketReactor::Register(SOCKET s, bool listening) {
+  epoll_event ev;
+  ev.events = EPOLLIN | EPOLLET;
+  if (!listening) {
+    ev.events |= EPOLLOUT | EPOLLRDHUP;
+  }
+  ev.data.fd = s;
+  if (epoll_ctl(epoll_, EPOLL_CTL_ADD, s, &ev) < 0) {
+    throw "Could not register socket";
+  }
+}
+
+void SocketReactor::Listen(SocketServer& server) {
+  SetNonBlocking(server.s_);
+  Register(server.s_, true);
+  listeners_.insert(server.s_);
+}
+
+ReactorConnection& SocketReactor::Add(Socket& socket) {
+  // The Socket object closes its handle when destroyed, so the
+  // reactor works with a duplicate
+  SOCKET s = dup(socket.s_);
+  if (s < 0) {
+    throw "Could not duplicate socket";
+  }
+  SetNonBlocking(s);
+  ReactorConnection* con = new ReactorConnection(*this, s, nextId_++);
+  byHandle_[s].reset(con);
+  byId_[con->id_] = con;
+  Register(s, false);
+  return *con;
+}
+
+ReactorConnection* SocketReactor::Find(int id) {
+  std::map<int, ReactorConnection*>::iterator it = byId_.find(id);
+  if (it == byId_.end()) return NULL;
+  return it->second;
+}
+
+size_t SocketReactor::Connections() const {
+  return byHandle_.size();
+}
+
+int SocketReactor::AddTimer(double seconds,
+                            const std::function<void()>& callback,
+                            bool repeat) {
+  Timer timer;
+  timer.interval = chrono::duration_cast<Clock::duration>
+    (chrono::duration<double>(seconds));
+  timer.repeat = repeat;
+  timer.callback = callback;
+  int id = nextTimer_++;
+  timers_[id] = timer;
+  due_.insert(make_pair(Clock::now() + timer.interval, id));
+  return id;
+}
+
+void SocketReactor::CancelTimer(int id) {
+  // The entry in due_ is dropped when it expires
+  timers_.erase(id);
+}
+
+void SocketReactor::RunTimers() {
+  Clock::time_point now = Clock::now();
+  while (!due_.empty() && due_.begin()->first <= now) {
+    pair<Clock::time_point, int> next = *due_.begin();
+    due_.erase(due_.begin());
+    std::map<int, Timer>::iterator it = timers_.find(next.second);
+    if (it == timers_.end()) continue;
+    // The callback may add or cancel timers
+    std::function<void()> callback = it->second.callback;
+    if (it->second.repeat) {
+      due_.insert(make_pair(next.first + it->second.interval, next.second));
+    } else {
+      timers_.erase(it);
+    }
+    callback();
+  }
+}
+
+// Time to wait in epoll_wait, limited by the next timer
+int SocketReactor::TimeoutMs(int timeoutMs) const {
+  if (due_.empty()) return timeoutMs;
+  Clock::duration left = due_.begin()->first - Clock::now();
+  long ms = chrono::duration_cast<chrono::milliseconds>(left).count() + 1;
+  if (ms < 0) ms = 0;
+  if (timeoutMs >= 0 && timeoutMs < ms) return timeoutMs;
+  return ms;
+}
+
+// Edge-triggered: accept until there are no more pending connections
+void SocketReactor::AcceptAll(SOCKET listener) {
+  while (true) {
+    SOCKET s = accept4(listener, 0, 0, SOCK_NONBLOCK);
+    if (s < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      return;
+    }
+    ReactorConnection* con = new ReactorConnection(*this, s, nextId_++);
+    byHandle_[s].reset(con);
+    byId_[con->id_] = con;
+    Register(s, false);
+    handler_.OnConnect(*con);
+  }
+}
+
+// Edge-triggered: read until the socket would block
+void SocketReactor::ReadAll(ReactorConnection& con) {
+  char buf[16384];
+  bool received = false;
+  bool ended = false;
+  while (true) {
+    ssize_t rv = recv(con.s_, buf, sizeof(buf), 0);
+    if (rv > 0) {
+      con.input_.append(buf, rv);
+      received = true;
+      continue;
+    }
+    if (rv == 0) {
+      // The peer has finished sending, but may still wait for
+      // the responses
+      ended = true;
+      break;
+    }
+    if (errno == EINTR) continue;
+    if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+    con.failed_ = true;
+    closed_.insert(&con);
+    break;
+  }
+  if (received) {
+    handler_.OnData(con);
+  }
+  if (ended && !con.ended_ && !con.failed_) {
+    con.ended_ = true;
+    handler_.OnEnd(con);
+  }
+}
+
+void SocketReactor::Remove(ReactorConnection& con) {
+  handler_.OnClose(con);
+  // In case OnClose called Close
+  closed_.erase(&con);
+  epoll_ctl(epoll_, EPOLL_CTL_DEL, con.s_, NULL);
+  byId_.erase(con.id_);
+  byHandle_.erase(con.s_);
+}
+
+void SocketReactor::RunOnce(int timeoutMs) {
+  epoll_event events[256];
+  int n = epoll_wait(epoll_, events, 256, TimeoutMs(timeoutMs));
+  for (int i = 0; i < n; i++) {
+    SOCKET s = events[i].data.fd;
+    if (listeners_.count(s)) {
+      AcceptAll(s);
+      continue;
+    }
+    std::map<SOCKET, std::unique_ptr<ReactorConnection> >::iterator it
+      = byHandle_.find(s);
+    if (it == byHandle_.end()) continue;
+    ReactorConnection& con = *it->second;
+    if (con.failed_) continue;
+    if (events[i].events & EPOLLOUT) {
+      if (!con.Flush()) closed_.insert(&con);
+    }
+    if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+      ReadAll(con);
+    }
+  }
+  RunTimers();
+  // Remove connections closed in this iteration
+  while (!closed_.empty()) {
+    ReactorConnection* con = *closed_.begin();
+    closed_.erase(closed_.begin());
+    Remove(*con);
+  }
+}
+
+void SocketReactor::Run() {
+  stopped_ = false;
+  while (!stopped_) {
+    RunOnce();
+  }
+}
+
+void SocketReactor::Stop() {
+  stopped_ = true;
+}
+
+#endif
@@ -6,15 +6,30 @@
  */
 #include "CSaugroboter.h"
 
+const double CSaugroboter::CONTACT_GAP = 1e-6;
+
 CSaugroboter::CSaugroboter() {
 
 	m_X_Pos = 0;
 	m_Y_Pos = 0;
 	m_RadAngle = 0;
 	m_DegAngle = 0;
-	m_Diameter = 1;
+	m_Diameter = .4;
+	m_bDisplay = true;
+
+
+}
 
+// Roboter in einer vorhandenen Welt (z.B. ohne Anzeige-Server), es wird
+// keine eigene Welt mit Verbindung zur Anzeige erzeugt
+CSaugroboter::CSaugroboter(const World & world) : m_world(world) {
 
+	m_X_Pos = 0;
+	m_Y_Pos = 0;
+	m_RadAngle = 0;
+	m_DegAngle = 0;
+	m_Diameter = .4;
+	m_bDisplay = true;
 }
 
 double CSaugroboter::Rad2Deg(double RadAngle) {
@@ -40,9 +55,29 @@ double CSaugroboter::Deg2Rad(double DegAngle) {
 
 void CSaugroboter::moveMeters(double nMove) 
 {
-	m_X_Pos = m_X_Pos + cos(m_RadAngle)*nMove;
-	m_Y_Pos = m_Y_Pos + sin(m_RadAngle)*nMove;
-	m_world.show(m_X_Pos,m_Y_Pos,m_RadAngle, .4);
+	// negative Werte: rueckwaerts fahren
+	double MoveAngle = m_RadAngle;
+	if (nMove < 0)
+	{
+		MoveAngle += M_PI;
+		nMove = -nMove;
+	}
+	// Bewegung an der ersten Wand stoppen, die der Roboter beruehrt
+	Vector2D Normal(Point2D(0, 0), Point2D(0, 0));
+	double Free = static_cast<double>(m_world.sweep(m_X_Pos, m_Y_Pos,
+			MoveAngle, nMove, Normal, m_Diameter));
+	if (Free < nMove)
+	{
+		// etwas Abstand lassen, damit Rundungsfehler den Roboter beim
+		// naechsten Schritt nicht in die Wand setzen
+		Free = Free > CONTACT_GAP ? Free - CONTACT_GAP : 0;
+	}
+	m_X_Pos = m_X_Pos + cos(MoveAngle)*Free;
+	m_Y_Pos = m_Y_Pos + sin(MoveAngle)*Free;
+	if (m_bDisplay)
+	{
+		m_world.show(m_X_Pos,m_Y_Pos,m_RadAngle, m_Diameter);
+	}
 	return;
 
 }
@@ -60,19 +95,27 @@ void CSaugroboter::rotateDegrees(double AddDeg) {
 	}
 
 	m_RadAngle = Deg2Rad(m_DegAngle);
-	m_world.show(m_X_Pos,m_Y_Pos,m_RadAngle, .4);
+	if (m_bDisplay)
+	{
+		m_world.show(m_X_Pos,m_Y_Pos,m_RadAngle, m_Diameter);
+	}
 	return;
 }
 
 void CSaugroboter::displayPositionandAngle() {
-	m_world.show(m_X_Pos,m_Y_Pos,m_RadAngle, .4);
+	m_world.show(m_X_Pos,m_Y_Pos,m_RadAngle, m_Diameter);
 	cout << "X Y pos: "<< m_X_Pos <<"," << m_Y_Pos << endl;
 	cout << "angle in Degrees:" << m_DegAngle << " in Radians " << m_RadAngle <<endl;
 	return;
 }
 
 void CSaugroboter::setWorld(World * world) {
-	m_world.show(m_X_Pos,m_Y_Pos,m_RadAngle, .4);
+	// Kopien einer Welt teilen sich den Raum
+	m_world = *world;
+	if (m_bDisplay)
+	{
+		m_world.show(m_X_Pos,m_Y_Pos,m_RadAngle, m_Diameter);
+	}
 
 	return;
 }
@@ -80,7 +123,6 @@ void CSaugroboter::setWorld(World * world) {
 
 CSaugroboter::~CSaugroboter() {
 
-	cout << "loops there is " << endl;
 }
 
 void CSaugroboter::resetDefaults() {
@@ -88,5 +130,36 @@ void CSaugroboter::resetDefaults() {
 	m_Y_Pos = 0;
 	m_RadAngle = 0;
 	m_DegAngle = 0;
-	m_Diameter = 1;
+	m_Diameter = .4;
+}
+
+void CSaugroboter::setPosition(double X_Pos, double Y_Pos, double DegAngle) {
+	m_X_Pos = X_Pos;
+	m_Y_Pos = Y_Pos;
+	m_DegAngle = 0;
+	rotateDegrees(DegAngle);
+}
+
+double CSaugroboter::getXPos() {
+	return m_X_Pos;
+}
+
+double CSaugroboter::getYPos() {
+	return m_Y_Pos;
+}
+
+double CSaugroboter::getDegAngle() {
+	return m_DegAngle;
+}
+
+// Abstand zwischen Vorderseite und naechster Wand in Fahrtrichtung
+double CSaugroboter::measureFront() {
+	return static_cast<double>(m_world.distanceFront(m_X_Pos, m_Y_Pos,
+			m_RadAngle, m_Diameter));
+}
+
+// Anzeige der Bewegungen ein- oder ausschalten (z.B. fuer Simulationen
+// mit vielen Robotern)
+void CSaugroboter::setDisplay(bool bDisplay) {
+	m_bDisplay = bDisplay;
 }
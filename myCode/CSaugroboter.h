@@ -23,12 +23,15 @@ private:
 	double m_DegAngle;
 	double m_RadAngle;
 	double m_Diameter;
+	bool m_bDisplay;
+	static const double CONTACT_GAP;
 	
 
 
 	public:
 	World m_world;
 	CSaugroboter();
+	CSaugroboter(const World & world);
 	~CSaugroboter();
 	double Rad2Deg(double RadAngle);
 	double Deg2Rad(double DegAngle);
@@ -37,6 +40,12 @@ private:
 	void displayPositionandAngle();
 	void setWorld(World * world);
 	void resetDefaults();
+	void setPosition(double X_Pos, double Y_Pos, double DegAngle);
+	double getXPos();
+	double getYPos();
+	double getDegAngle();
+	double measureFront();
+	void setDisplay(bool bDisplay);
 	
 
 };
@@ -0,0 +1,89 @@
+/*
+ * CSimulation.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: ben
+ */
+#include "CSimulation.h"
+
+const size_t CSimulation::ROBOTS_PER_TASK = 64;
+
+CSimulation::CSimulation(World * world, unsigned nThreads,
+		double dStepLength) : m_world(*world), m_Pool(nThreads) {
+
+	m_dStepLength = dStepLength;
+	m_cntSteps = 0;
+}
+
+void CSimulation::addRobot(double X_Pos, double Y_Pos, double DegAngle) {
+	m_Robots.emplace_back(m_world);
+	CSaugroboter& robot = m_Robots.back();
+	robot.setDisplay(false);
+	robot.setPosition(X_Pos, Y_Pos, DegAngle);
+	// jeder Roboter hat seinen eigenen Zufallszahlengenerator
+	m_RandomStates.push_back(2654435761u * (m_RandomStates.size() + 1));
+}
+
+// Ein Takt fuer einen Roboter
+void CSimulation::stepRobot(size_t idxRobot) {
+	CSaugroboter& robot = m_Robots[idxRobot];
+	// Sensorik
+	double Front = robot.measureFront();
+	// Steuerung und Bewegung: vor einer Wand um einen zufaelligen
+	// Winkel drehen, sonst geradeaus fahren
+	if (Front < m_dStepLength)
+	{
+		uint32_t& state = m_RandomStates[idxRobot];
+		state = state * 1664525u + 1013904223u;
+		robot.rotateDegrees(90 + (state >> 8) % 180);
+	}
+	else
+	{
+		robot.moveMeters(m_dStepLength);
+	}
+}
+
+void CSimulation::step() {
+	m_Pool.parallelFor(m_Robots.size(), ROBOTS_PER_TASK,
+			[this] (size_t first, size_t last) {
+				for (size_t i = first; i < last; i++)
+				{
+					stepRobot(i);
+				}
+			});
+	m_cntSteps += m_Robots.size();
+}
+
+void CSimulation::run(unsigned nTicks) {
+	for (unsigned i = 0; i < nTicks; i++)
+	{
+		step();
+	}
+}
+
+size_t CSimulation::getRobotCount() {
+	return m_Robots.size();
+}
+
+CSaugroboter& CSimulation::getRobot(size_t idxRobot) {
+	return m_Robots[idxRobot];
+}
+
+unsigned CSimulation::getThreadCount() {
+	return m_Pool.getThreadCount();
+}
+
+unsigned long CSimulation::getStepCount() {
+	return m_cntSteps;
+}
+
+// Pruefsumme ueber die Positionen aller Roboter (zum Vergleich von
+// Laeufen mit unterschiedlicher Anzahl von Threads)
+double CSimulation::checksum() {
+	double Sum = 0;
+	for (size_t i = 0; i < m_Robots.size(); i++)
+	{
+		Sum += m_Robots[i].getXPos() * (i + 1) + m_Robots[i].getYPos();
+	}
+	return Sum;
+}
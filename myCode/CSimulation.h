@@ -0,0 +1,49 @@
+/*
+ * CSimulation.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: ben
+ */
+#include <vector>
+#include <stdint.h>
+#include "CSaugroboter.h"
+#include "CThreadPool.h"
+
+#ifndef CSIMULATION_H_
+#define CSIMULATION_H_
+
+// Simulation vieler Saugroboter ohne Anzeige. Alle Roboter teilen sich
+// den Raum der uebergebenen Welt. In jedem Takt misst jeder Roboter den
+// Abstand nach vorne (Sensorik), entscheidet, ob er sich dreht oder
+// faehrt (Steuerung) und bewegt sich (Bewegung). Die Roboter eines
+// Takts werden parallel auf dem Thread-Pool bearbeitet. Da jeder
+// Roboter nur seinen eigenen Zustand (einschliesslich seines eigenen
+// Zufallszahlengenerators) veraendert, ist das Ergebnis unabhaengig von
+// der Anzahl der Threads.
+class CSimulation
+{
+private:
+	World m_world;
+	std::vector<CSaugroboter> m_Robots;
+	std::vector<uint32_t> m_RandomStates;
+	CThreadPool m_Pool;
+	double m_dStepLength;
+	unsigned long m_cntSteps;
+	static const size_t ROBOTS_PER_TASK;
+
+	void stepRobot(size_t idxRobot);
+
+public:
+	CSimulation(World * world, unsigned nThreads = 0,
+			double dStepLength = 0.05);
+	void addRobot(double X_Pos, double Y_Pos, double DegAngle);
+	void step();
+	void run(unsigned nTicks);
+	size_t getRobotCount();
+	CSaugroboter& getRobot(size_t idxRobot);
+	unsigned getThreadCount();
+	unsigned long getStepCount();
+	double checksum();
+};
+
+#endif /* CSIMULATION_H_ */
@@ -0,0 +1,144 @@
+/*
+ * CThreadPool.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: ben
+ */
+#include <algorithm>
+#include "CThreadPool.h"
+
+CThreadPool::CThreadPool(unsigned nThreads) {
+
+	if (nThreads == 0)
+	{
+		nThreads = std::thread::hardware_concurrency();
+	}
+	if (nThreads == 0)
+	{
+		nThreads = 1;
+	}
+	m_pJob = NULL;
+	m_cntPending = 0;
+	m_nGeneration = 0;
+	m_bStop = false;
+	for (unsigned i = 0; i < nThreads; i++)
+	{
+		m_Queues.push_back(std::unique_ptr<SQueue>(new SQueue));
+	}
+	for (unsigned i = 1; i < nThreads; i++)
+	{
+		m_Threads.push_back(std::thread(&CThreadPool::workerLoop, this, i));
+	}
+}
+
+CThreadPool::~CThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_bStop = true;
+	}
+	m_WakeUp.notify_all();
+	for (size_t i = 0; i < m_Threads.size(); i++)
+	{
+		m_Threads[i].join();
+	}
+}
+
+unsigned CThreadPool::getThreadCount() const {
+	return m_Queues.size();
+}
+
+void CThreadPool::parallelFor(size_t nCount, size_t nGrain,
+		const std::function<void(size_t, size_t)>& job) {
+	if (nCount == 0)
+	{
+		return;
+	}
+	if (nGrain == 0)
+	{
+		nGrain = 1;
+	}
+	size_t nRanges = (nCount + nGrain - 1) / nGrain;
+	m_pJob = &job;
+	m_cntPending = nRanges;
+	// zusammenhaengende Bloecke von Teilbereichen auf die Threads
+	// verteilen, damit jeder Thread moeglichst lange bei "seinen"
+	// Daten bleibt
+	for (size_t r = 0; r < nRanges; r++)
+	{
+		SQueue& queue = *m_Queues[r * m_Queues.size() / nRanges];
+		SRange range = { r * nGrain, std::min(nCount, (r + 1) * nGrain) };
+		std::lock_guard<std::mutex> lock(queue.m_Mutex);
+		queue.m_Ranges.push_back(range);
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_nGeneration++;
+	}
+	m_WakeUp.notify_all();
+
+	// mitarbeiten, danach auf die anderen Threads warten
+	while (runOne(0))
+	{
+	}
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_Done.wait(lock, [this] { return m_cntPending == 0; });
+	m_pJob = NULL;
+}
+
+// Einen Teilbereich aus der eigenen Warteschlange (von vorne) oder aus
+// einer fremden Warteschlange (von hinten) holen und bearbeiten.
+// Liefert false, wenn keine Arbeit mehr gefunden wurde.
+bool CThreadPool::runOne(size_t idxQueue) {
+	SRange range;
+	bool bFound = false;
+	for (size_t k = 0; k < m_Queues.size() && !bFound; k++)
+	{
+		SQueue& queue = *m_Queues[(idxQueue + k) % m_Queues.size()];
+		std::lock_guard<std::mutex> lock(queue.m_Mutex);
+		if (!queue.m_Ranges.empty())
+		{
+			if (k == 0)
+			{
+				range = queue.m_Ranges.front();
+				queue.m_Ranges.pop_front();
+			}
+			else
+			{
+				range = queue.m_Ranges.back();
+				queue.m_Ranges.pop_back();
+			}
+			bFound = true;
+		}
+	}
+	if (!bFound)
+	{
+		return false;
+	}
+	(*m_pJob)(range.m_nFirst, range.m_nLast);
+	if (--m_cntPending == 0)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Done.notify_all();
+	}
+	return true;
+}
+
+void CThreadPool::workerLoop(size_t idxQueue) {
+	size_t nSeen = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_WakeUp.wait(lock,
+					[&] { return m_bStop || m_nGeneration != nSeen; });
+			if (m_bStop)
+			{
+				return;
+			}
+			nSeen = m_nGeneration;
+		}
+		while (runOne(idxQueue))
+		{
+		}
+	}
+}
@@ -0,0 +1,69 @@
+/*
+ * CThreadPool.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: ben
+ */
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#ifndef CTHREADPOOL_H_
+#define CTHREADPOOL_H_
+
+// Thread-Pool mit Work-Stealing: jeder Thread hat eine eigene
+// Warteschlange mit Teilbereichen einer Schleife. Ist die eigene
+// Warteschlange leer, "stiehlt" der Thread Teilbereiche vom Ende der
+// Warteschlangen der anderen Threads. Der aufrufende Thread arbeitet
+// in parallelFor mit.
+class CThreadPool
+{
+private:
+	struct SRange
+	{
+		size_t m_nFirst;
+		size_t m_nLast;
+	};
+
+	struct SQueue
+	{
+		std::mutex m_Mutex;
+		std::deque<SRange> m_Ranges;
+	};
+
+	std::vector<std::thread> m_Threads;
+	// Warteschlange 0 gehoert dem aufrufenden Thread
+	std::vector<std::unique_ptr<SQueue> > m_Queues;
+	const std::function<void(size_t, size_t)>* m_pJob;
+	std::atomic<size_t> m_cntPending;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_WakeUp;
+	std::condition_variable m_Done;
+	size_t m_nGeneration;
+	bool m_bStop;
+
+	void workerLoop(size_t idxQueue);
+	bool runOne(size_t idxQueue);
+
+public:
+	// nThreads ist die Anzahl der Threads einschliesslich des
+	// aufrufenden Threads (0: Anzahl der Prozessorkerne)
+	CThreadPool(unsigned nThreads = 0);
+	~CThreadPool();
+	unsigned getThreadCount() const;
+
+	// Ruft job(first, last) fuer Teilbereiche von [0, nCount) mit
+	// hoechstens nGrain Elementen auf und kehrt zurueck, wenn alle
+	// Teilbereiche bearbeitet sind.
+	void parallelFor(size_t nCount, size_t nGrain,
+			const std::function<void(size_t, size_t)>& job);
+};
+
+#endif /* CTHREADPOOL_H_ */
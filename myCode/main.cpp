@@ -5,6 +5,19 @@
 // Header-Dateien
 // TODO: Fgen Sie hier weitere bentigte Header-Dateien ein
 #include "CSaugroboter.h"
+#include "CSimulation.h"
+#include <chrono>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "cleanerbot/DisplayServer.h"
+#include "cleanerbot/SegmentScene.h"
 
 
 	// Erspart den scope vor Objekte der
@@ -14,10 +27,495 @@
 // Inkludieren Sie die Header-Datei Ihrer Klasse
 
 
+// Raum mit 20 x 20 m und Zwischenwaenden fuer Simulation und
+// Belastungstest
+void buildTestRoom(Room& room)
+{
+	room.addWall(Wall(Point2D(-10, -10), Point2D(10, -10)));
+	room.addWall(Wall(Point2D(10, -10), Point2D(10, 10)));
+	room.addWall(Wall(Point2D(10, 10), Point2D(-10, 10)));
+	room.addWall(Wall(Point2D(-10, 10), Point2D(-10, -10)));
+	for (int i = -2; i <= 2; i++)
+	{
+		room.addWall(Wall(Point2D(i * 4, -6), Point2D(i * 4, 2)));
+		room.addWall(Wall(Point2D(-8, i * 4 + 1), Point2D(-4, i * 4 + 1)));
+	}
+}
+
+// Simulation vieler Roboter ohne Anzeige im Testraum, Ausgabe des
+// Durchsatzes (Roboter-Schritte pro Sekunde)
+int simulate(int nRobots, int nTicks, int nThreads)
+{
+	Room room;
+	buildTestRoom(room);
+	World world(World::HEADLESS);
+	world.setRoom(room);
+
+	CSimulation sim(&world, nThreads);
+	int nPlaced = 0;
+	for (int i = 0; nPlaced < nRobots; i++)
+	{
+		// Startpositionen auf einem Gitter, nur wo der Roboter Platz hat
+		double X_Pos = -9.5 + (i % 95) * 0.2;
+		double Y_Pos = -9.5 + ((i / 95) % 95) * 0.2;
+		if (world.clearance(X_Pos, Y_Pos) > 0.05)
+		{
+			sim.addRobot(X_Pos, Y_Pos, (i * 37) % 360);
+			nPlaced++;
+		}
+	}
+
+	std::chrono::steady_clock::time_point start
+		= std::chrono::steady_clock::now();
+	sim.run(nTicks);
+	double Seconds = std::chrono::duration<double>
+		(std::chrono::steady_clock::now() - start).count();
+	cout << sim.getRobotCount() << " Roboter, " << nTicks << " Takte, "
+		 << sim.getThreadCount() << " Threads: " << Seconds << " s, "
+		 << sim.getStepCount() / Seconds << " Roboter-Schritte/s" << endl;
+	cout << "Pruefsumme: " << sim.checksum() << endl;
+	return 0;
+}
+
+// Belastungstest fuer die in World.h zugesicherte Nebenlaeufigkeit:
+// Mehrere Threads stellen gleichzeitig alle konstanten Abfragen an
+// dieselbe Welt und erzeugen, kopieren und zerstoeren dabei Welten, die
+// denselben Raum verwenden. Gedacht fuer einen Build mit
+// "-fsanitize=thread", der keine Warnungen ausgeben darf. Die
+// Pruefsumme haengt nur von den Parametern ab.
+int stress(int nThreads, int nRounds)
+{
+	Room room;
+	buildTestRoom(room);
+	room.buildClearance();
+	World world(World::HEADLESS);
+	world.setRoom(room);
+
+	std::vector<double> Sums(nThreads);
+	std::vector<std::thread> Threads;
+	for (int t = 0; t < nThreads; t++)
+	{
+		Threads.emplace_back([&world, &room, &Sums, t, nRounds]()
+		{
+			const int nRays = 32;
+			Scalar Distances[nRays];
+			Vector2D Normal(Point2D(0, 0), Point2D(0, 0));
+			double Sum = 0;
+			for (int i = 0; i < nRounds; i++)
+			{
+				double X_Pos = -9.5 + (i * 7 % 190) * 0.1;
+				double Y_Pos = -9.5 + ((i * 13 + t * 29) % 190) * 0.1;
+				double Angle = i * 0.1 + t;
+				// Kopie, die in diesem Thread wieder zerstoert wird,
+				// abwechselnd mit dem Original abgefragt
+				World Copy(world);
+				const World& Query = i % 2 == 0 ? world : Copy;
+				Sum += static_cast<double>(Query.distanceFront(X_Pos, Y_Pos,
+						Angle));
+				Sum += static_cast<double>(Query.distanceLeft(X_Pos, Y_Pos,
+						Angle));
+				Sum += static_cast<double>(Query.distanceRight(X_Pos, Y_Pos,
+						Angle));
+				Query.scan(X_Pos, Y_Pos, Angle, 2 * M_PI, nRays, Distances);
+				Sum += static_cast<double>(Distances[i % nRays]);
+				Sum += static_cast<double>(Query.sweep(X_Pos, Y_Pos, Angle,
+						1, Normal));
+				Sum += static_cast<double>(Query.clearance(X_Pos, Y_Pos));
+				Vector2D Gradient = Query.clearanceGradient(X_Pos, Y_Pos);
+				Sum += static_cast<double>(Gradient.dx());
+				if (i % 100 == 0)
+				{
+					// Neue Welt mit einem eigenen Schnappschuss des Raums
+					World Fresh(World::HEADLESS);
+					Fresh.setRoom(room);
+					Sum += static_cast<double>(Fresh.clearance(X_Pos, Y_Pos));
+				}
+			}
+			Sums[t] = Sum;
+		});
+	}
+	double Sum = 0;
+	for (int t = 0; t < nThreads; t++)
+	{
+		Threads[t].join();
+		Sum += Sums[t];
+	}
+	cout << nThreads << " Threads, " << nRounds << " Runden" << endl;
+	cout << "Pruefsumme: " << Sum << endl;
+	return 0;
+}
+
+// Vergleich der Suchstrukturen des Raums (alle Kanten, Hierarchie
+// umschliessender Rechtecke, gleichmaessiges Gitter) fuer ein Raster von
+// n x n Zimmern mit 4 m Kantenlaenge und Tuerdurchgaengen. Ausgegeben
+// werden die Zeit pro Strahl und die Abweichungen von den Ergebnissen
+// ohne Suchstruktur. Trifft ein Strahl eine Ecke, liefern die dort
+// zusammentreffenden Kanten Entfernungen, die sich in den letzten
+// Stellen unterscheiden. Welche davon gefunden wird, haengt von der
+// Reihenfolge der Suche ab, die Ergebnisse sind daher nicht genau
+// gleich.
+int benchmarkAccelerators(int nRooms, int nRays)
+{
+	const char* Names[] = { "alle Kanten", "Hierarchie", "Gitter" };
+	const Room::Accelerator Accelerators[] = { Room::LINEAR_SCAN,
+			Room::BOUNDING_VOLUMES, Room::UNIFORM_GRID };
+	std::vector<Scalar> Reference(nRays);
+	for (int a = 0; a < 3; a++)
+	{
+		Room R;
+		for (int i = 0; i <= nRooms; i++)
+		{
+			for (int j = 0; j < nRooms; j++)
+			{
+				R.addWall(Wall(Point2D(i * 4, j * 4), Point2D(i * 4, j * 4 + 3)));
+				R.addWall(Wall(Point2D(j * 4, i * 4), Point2D(j * 4 + 3, i * 4)));
+			}
+		}
+		R.setAccelerator(Accelerators[a]);
+		std::chrono::steady_clock::time_point start
+			= std::chrono::steady_clock::now();
+		R.bake();
+		double SecondsBuild = std::chrono::duration<double>
+			(std::chrono::steady_clock::now() - start).count();
+
+		srand(1);
+		int nDiffering = 0;
+		double MaxDeviation = 0;
+		start = std::chrono::steady_clock::now();
+		for (int i = 0; i < nRays; i++)
+		{
+			double X_Pos = nRooms * 4.0 * rand() / RAND_MAX;
+			double Y_Pos = nRooms * 4.0 * rand() / RAND_MAX;
+			double Angle = 2 * M_PI * rand() / RAND_MAX;
+			Scalar Distance = R.distance(Ray2D(Point2D(X_Pos, Y_Pos), Angle));
+			if (a == 0)
+			{
+				Reference[i] = Distance;
+			}
+			else if (Distance != Reference[i])
+			{
+				nDiffering++;
+				MaxDeviation = std::max(MaxDeviation, std::abs(
+						static_cast<double>(Distance - Reference[i])));
+			}
+		}
+		double Seconds = std::chrono::duration<double>
+			(std::chrono::steady_clock::now() - start).count();
+		cout << Names[a] << ": " << R.getEdgeCount() << " Kanten, Aufbau "
+			 << SecondsBuild * 1e3 << " ms, "
+			 << Seconds * 1e6 / nRays << " us/Strahl";
+		if (a > 0)
+		{
+			cout << ", Abweichungen " << nDiffering << " (max. "
+				 << MaxDeviation << ")";
+		}
+		cout << endl;
+	}
+	return 0;
+}
+
+// Genauigkeit der Entfernungsberechnung mit einfacher Genauigkeit: Der
+// erste Aufruf (mit dem normalen Build) schreibt fuer einen zufaelligen
+// Raum mit 3000 Waenden die Entfernungen von 20000 zufaelligen
+// Strahlen fuer jede Suchstruktur in die Datei. Ein weiterer Aufruf
+// (mit dem Build mit CLEANERBOT_FLOAT) vergleicht seine Ergebnisse
+// damit und gibt Unterschiede bei Treffern, den groessten Fehler, das
+// 99%-Quantil und die Anzahl der Fehler ueber 1 mm aus.
+int checkAccuracy(const std::string& FileName)
+{
+	const int nWalls = 3000;
+	const int nRays = 20000;
+	const Room::Accelerator Accelerators[] = { Room::LINEAR_SCAN,
+			Room::BOUNDING_VOLUMES, Room::UNIFORM_GRID };
+	srand(1);
+	Room R;
+	for (int i = 0; i < nWalls; i++)
+	{
+		double X_Pos = 100.0 * rand() / RAND_MAX;
+		double Y_Pos = 100.0 * rand() / RAND_MAX;
+		double Angle = 2 * M_PI * rand() / RAND_MAX;
+		double Length = 0.1 + 5.0 * rand() / RAND_MAX;
+		R.addWall(Wall(Point2D(X_Pos, Y_Pos), Point2D(X_Pos
+				+ Length * cos(Angle), Y_Pos + Length * sin(Angle))));
+	}
+	std::vector<Ray2D> Rays;
+	for (int i = 0; i < nRays; i++)
+	{
+		double X_Pos = 100.0 * rand() / RAND_MAX;
+		double Y_Pos = 100.0 * rand() / RAND_MAX;
+		double Angle = 2 * M_PI * rand() / RAND_MAX;
+		Rays.push_back(Ray2D(Point2D(X_Pos, Y_Pos), Angle));
+	}
+
+	// Entfernungen aller Suchstrukturen, -1 fuer "kein Treffer"
+	std::vector<double> Distances;
+	for (int a = 0; a < 3; a++)
+	{
+		R.setAccelerator(Accelerators[a]);
+		R.bake();
+		for (int i = 0; i < nRays; i++)
+		{
+			Scalar Distance = R.distance(Rays[i]);
+			Distances.push_back(Distance == std::numeric_limits<Scalar>::max()
+					? -1 : static_cast<double>(Distance));
+		}
+	}
+
+	std::ifstream In(FileName.c_str());
+	if (!In)
+	{
+		std::ofstream Out(FileName.c_str());
+		Out << std::setprecision(17);
+		for (size_t i = 0; i < Distances.size(); i++)
+		{
+			Out << Distances[i] << "\n";
+		}
+		cout << Distances.size() << " Entfernungen nach " << FileName
+			 << " geschrieben" << endl;
+		return Out ? 0 : 1;
+	}
+
+	std::vector<double> Errors;
+	int nHitMismatches = 0;
+	for (size_t i = 0; i < Distances.size(); i++)
+	{
+		double Reference;
+		if (!(In >> Reference))
+		{
+			cout << FileName << " enthaelt zu wenige Entfernungen" << endl;
+			return 1;
+		}
+		if ((Reference < 0) != (Distances[i] < 0))
+		{
+			nHitMismatches++;
+		}
+		else if (Reference >= 0)
+		{
+			Errors.push_back(std::abs(Distances[i] - Reference));
+		}
+	}
+	std::sort(Errors.begin(), Errors.end());
+	int nAboveMillimeter = Errors.end()
+		- std::upper_bound(Errors.begin(), Errors.end(), 1e-3);
+	cout << Distances.size() << " Entfernungen, Treffer verschieden: "
+		 << nHitMismatches << endl;
+	if (!Errors.empty())
+	{
+		cout << "Fehler max. " << Errors.back() << " m, 99%-Quantil "
+			 << Errors[Errors.size() * 99 / 100] << " m, ueber 1 mm: "
+			 << nAboveMillimeter << endl;
+	}
+	return 0;
+}
+
+// Vergleich von SegmentScene::scan mit einzelnen Strahlen, die genau
+// dieselben Entfernungen liefern muessen. Geprueft werden Faecher, deren
+// Strahlen genau durch Ecken eines Rasters von Kanten laufen, und
+// Faecher von Ursprungspunkten, die auf einer Kante (oder ihrer
+// Verlaengerung) liegen. Ausgegeben wird die Zahl der Abweichungen.
+int checkScan(int nPoses)
+{
+	const int nRays = 720;
+	const double Step = 2 * M_PI / nRays;
+	Scalar Distances[nRays];
+	srand(1);
+	int nRaysChecked = 0;
+	int nCorner = 0;
+	int nOnEdge = 0;
+
+	SegmentScene Grid;
+	for (int i = 0; i <= 6; i++)
+	{
+		for (int j = 0; j < 6; j++)
+		{
+			Grid.add(Segment2D(Point2D(i * 4, j * 4), Point2D(i * 4, j * 4 + 3)));
+			Grid.add(Segment2D(Point2D(j * 4, i * 4), Point2D(j * 4 + 3, i * 4)));
+		}
+	}
+	for (int p = 0; p < nPoses; p++)
+	{
+		// Faecher, die so ausgerichtet sind, dass ein Strahl genau
+		// durch eine Ecke laeuft
+		double X_Pos = 0.5 + rand() % 23;
+		double Y_Pos = 0.5 + rand() % 23;
+		double X_Corner = 4 * (rand() % 6);
+		double Y_Corner = 4 * (rand() % 6) + (p % 2) * 3;
+		double First = atan2(Y_Corner - Y_Pos, X_Corner - X_Pos) - 100 * Step;
+		Grid.scan(Point2D(X_Pos, Y_Pos), Scalar(First), Scalar(Step), nRays,
+				Distances);
+		for (int i = 0; i < nRays; i++)
+		{
+			Ray2D Ray(Point2D(X_Pos, Y_Pos), Scalar(First) + i * Scalar(Step));
+			nCorner += Grid.distance(Ray) != Distances[i];
+			nRaysChecked++;
+		}
+	}
+
+	for (int p = 0; p < nPoses; p++)
+	{
+		// Zufaellige Kanten mit ganzzahligen Koordinaten, der Ursprung
+		// liegt auf einem Endpunkt, einer Kantenmitte oder einem
+		// beliebigen ganzzahligen Punkt
+		SegmentScene Scene;
+		for (int w = 0; w < 15; w++)
+		{
+			Point2D Start(rand() % 10, rand() % 10);
+			Point2D End(rand() % 10, rand() % 10);
+			Scene.add(Segment2D(Start, End));
+		}
+		double X_Pos = rand() % 10;
+		double Y_Pos = rand() % 10;
+		if (p % 3 == 1)
+		{
+			X_Pos += 0.5;
+		}
+		else if (p % 3 == 2)
+		{
+			Y_Pos += 0.5;
+		}
+		double First = (rand() % nRays) * Step;
+		Scene.scan(Point2D(X_Pos, Y_Pos), Scalar(First), Scalar(Step), nRays,
+				Distances);
+		for (int i = 0; i < nRays; i++)
+		{
+			Ray2D Ray(Point2D(X_Pos, Y_Pos), Scalar(First) + i * Scalar(Step));
+			nOnEdge += Scene.distance(Ray) != Distances[i];
+			nRaysChecked++;
+		}
+	}
+	cout << nRaysChecked << " Strahlen, Abweichungen durch Ecken: " << nCorner
+		 << ", auf Kanten: " << nOnEdge << endl;
+	return nCorner + nOnEdge > 0;
+}
+
+// Vergleich der Kodierung von "VACUUM CLEANER"-Kommandos mit
+// stringstream (wie frueher in World::show) und mit dem CommandEncoder,
+// der direkt in einen wiederverwendeten Puffer schreibt. Der Puffer wird
+// wie der Sendepuffer der Verbindung regelmaessig geleert.
+int benchmarkEncoder(int nCommands)
+{
+	std::string Buffer;
+	double Sum = 0;
+	std::chrono::steady_clock::time_point start
+		= std::chrono::steady_clock::now();
+	for (int i = 0; i < nCommands; i++)
+	{
+		double Angle = i * 0.01;
+		std::stringstream cmd;
+		cmd << "VACUUM CLEANER " << i * 0.001 << "," << 2.5 << ";"
+			<< cos(Angle) << "," << sin(Angle) << ";" << 0.4;
+		std::string Line = cmd.str();
+		Buffer += Line + "\r\n";
+		if (i % 1000 == 999)
+		{
+			Sum += Buffer.size();
+			Buffer.clear();
+		}
+	}
+	double SecondsStream = std::chrono::duration<double>
+		(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < nCommands; i++)
+	{
+		CommandEncoder(Buffer, CommandEncoder::LINE)
+			.show(i * 0.001, 2.5, i * 0.01, 0.4);
+		if (i % 1000 == 999)
+		{
+			Sum += Buffer.size();
+			Buffer.clear();
+		}
+	}
+	double SecondsEncoder = std::chrono::duration<double>
+		(std::chrono::steady_clock::now() - start).count();
+
+	cout << nCommands << " Kommandos: stringstream "
+		 << SecondsStream * 1e9 / nCommands << " ns/Kommando, "
+		 << "CommandEncoder "
+		 << SecondsEncoder * 1e9 / nCommands << " ns/Kommando" << endl;
+	cout << "Bytes: " << Sum << endl;
+	return 0;
+}
+
+#ifdef __linux__
+// Startet den Ersatz fuer den Anzeige-Server, der die Kommandos nur
+// beantwortet und die Antwortzeiten misst. Ohne Laufzeit wird die
+// Statistik alle 10 s ausgegeben, bis das Programm beendet wird. Mit
+// "text" wird (wie von der urspruenglichen Konsole) nur das
+// Textprotokoll angeboten.
+int runDisplayServer(int Port, double LatencyMs, double Seconds, bool TextOnly)
+{
+	DisplayServer Server(Port);
+	Server.setLatency(LatencyMs / 1000);
+	Server.setBinarySupported(!TextOnly);
+	cout << "Anzeige-Server auf Port " << Port << ", Verzoegerung "
+		 << LatencyMs << " ms" << endl;
+	if (Seconds > 0)
+	{
+		Server.run(Seconds);
+		Server.report(cout);
+		return 0;
+	}
+	while (1)
+	{
+		Server.run(10);
+		Server.report(cout);
+	}
+	return 0;
+}
+#endif
+
 // Hauptprogramm
 // Dient als Testrahmen, von hier aus werden die Klassen aufgerufen
-int main (void)
+// Aufruf mit "sim [Roboter] [Takte] [Threads]" startet die Simulation,
+// "stress [Threads] [Runden]" den Belastungstest fuer gleichzeitige
+// Abfragen, "bench [Zimmer je Achse] [Strahlen]" den Vergleich der
+// Suchstrukturen, "accuracy Datei" den Vergleich einfacher mit doppelter
+// Genauigkeit, "scan [Posen]" den Vergleich von Faechern mit einzelnen
+// Strahlen, "encode [Kommandos]" den Vergleich der Kodierung von
+// Kommandos,
+// "display [Port] [Verzoegerung in ms] [Sekunden] [text]" den Ersatz
+// fuer den Anzeige-Server
+int main (int argc, char* argv[])
 {
+	if (argc > 1 && std::string(argv[1]) == "sim")
+	{
+		return simulate(argc > 2 ? atoi(argv[2]) : 1000,
+				argc > 3 ? atoi(argv[3]) : 1000,
+				argc > 4 ? atoi(argv[4]) : 0);
+	}
+	if (argc > 1 && std::string(argv[1]) == "stress")
+	{
+		return stress(argc > 2 ? atoi(argv[2]) : 8,
+				argc > 3 ? atoi(argv[3]) : 10000);
+	}
+	if (argc > 1 && std::string(argv[1]) == "bench")
+	{
+		return benchmarkAccelerators(argc > 2 ? atoi(argv[2]) : 20,
+				argc > 3 ? atoi(argv[3]) : 200000);
+	}
+	if (argc > 2 && std::string(argv[1]) == "accuracy")
+	{
+		return checkAccuracy(argv[2]);
+	}
+	if (argc > 1 && std::string(argv[1]) == "scan")
+	{
+		return checkScan(argc > 2 ? atoi(argv[2]) : 2000);
+	}
+	if (argc > 1 && std::string(argv[1]) == "encode")
+	{
+		return benchmarkEncoder(argc > 2 ? atoi(argv[2]) : 1000000);
+	}
+#ifdef __linux__
+	if (argc > 1 && std::string(argv[1]) == "display")
+	{
+		return runDisplayServer(argc > 2 ? atoi(argv[2]) : 23454,
+				argc > 3 ? atof(argv[3]) : 0,
+				argc > 4 ? atof(argv[4]) : 0,
+				argc > 5 && std::string(argv[5]) == "text");
+	}
+#endif
+
 	CSaugroboter C;
 
 	while (1)